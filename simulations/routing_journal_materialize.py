@@ -0,0 +1,96 @@
+"""Rebuild routing tables from routing_tables/node_<id>_routing_journal.csv.
+
+LoRaNodeApp writes these journals when run with ``routingLogMode = "journal"``:
+every row is an ADD, UPD or DEL of one route keyed by (id, via, sf), where sf is
+empty for single-metric routes. Replaying the rows up to a given time yields the
+table the node held at that time, in the same column layout as the legacy
+node_<id>_routing.csv snapshots.
+
+Examples:
+    python routing_journal_materialize.py routing_tables --time 1200
+    python routing_journal_materialize.py routing_tables/node_3_routing_journal.csv --out node3_t600.csv --time 600
+"""
+
+import argparse
+import csv
+import glob
+import os
+import sys
+from typing import Dict, List, Optional, Tuple
+
+Key = Tuple[int, int, str]
+
+OUT_COLUMNS = [
+    'nodeId',
+    'id',
+    'via',
+    'sf',
+    'metric',
+    'priMetric',
+    'secMetric',
+    'validUntil',
+    'seqNum',
+    'isValid',
+    'lastChange',
+    'lastEvent',
+]
+
+
+def journal_files(paths: List[str]) -> List[str]:
+    files: List[str] = []
+    for path in paths:
+        if os.path.isdir(path):
+            files.extend(sorted(glob.glob(os.path.join(path, 'node_*_routing_journal.csv'))))
+        else:
+            files.append(path)
+    return files
+
+
+def materialize(path: str, at_time: Optional[float]) -> Dict[Key, dict]:
+    """Replay one journal up to (and including) at_time; None replays everything."""
+    table: Dict[Key, dict] = {}
+    with open(path, newline='') as fh:
+        for row in csv.DictReader(fh):
+            t = float(row['simTime'])
+            if at_time is not None and t > at_time:
+                break  # journal rows are appended in simulation time order
+            key = (int(row['id']), int(row['via']), row['sf'])
+            if row['op'] == 'DEL':
+                table.pop(key, None)
+                continue
+            entry = {col: row.get(col, '') for col in OUT_COLUMNS if col in row}
+            entry['lastChange'] = row['simTime']
+            entry['lastEvent'] = row['event']
+            table[key] = entry
+    return table
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description='Materialize routing tables from routing journals.')
+    parser.add_argument('paths', nargs='+', help='journal files or directories containing them')
+    parser.add_argument('--time', type=float, default=None,
+                        help='simulation time (s) to materialize; default is the end of the run')
+    parser.add_argument('--out', default=None, help='output CSV (default: stdout)')
+    args = parser.parse_args()
+
+    files = journal_files(args.paths)
+    if not files:
+        print('No routing journals found', file=sys.stderr)
+        return 1
+
+    out = open(args.out, 'w', newline='') if args.out else sys.stdout
+    try:
+        writer = csv.DictWriter(out, fieldnames=OUT_COLUMNS)
+        writer.writeheader()
+        for path in files:
+            table = materialize(path, args.time)
+            for key in sorted(table, key=lambda k: (k[0], k[1], k[2])):
+                writer.writerow(table[key])
+    finally:
+        if out is not sys.stdout:
+            out.close()
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
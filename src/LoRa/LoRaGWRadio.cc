@@ -14,6 +14,7 @@
 // 
 
 #include "LoRaGWRadio.h"
+#include "misc/LoRaScalarCollector.h"
 #include "LoRaPhy/LoRaMedium.h"
 
 namespace inet {
@@ -39,7 +40,7 @@ void LoRaGWRadio::initialize(int stage)
 void LoRaGWRadio::finish()
 {
     FlatRadioBase::finish();
-    recordScalar("DER - Data Extraction Rate", double(LoRaGWRadioReceptionFinishedCorrect_counter)/LoRaGWRadioReceptionStarted_counter);
+    LoRaScalarCollector::record(this, "DER - Data Extraction Rate", double(LoRaGWRadioReceptionFinishedCorrect_counter)/LoRaGWRadioReceptionStarted_counter);
 }
 
 void LoRaGWRadio::handleSelfMessage(cMessage *message)
@@ -144,14 +145,13 @@ void LoRaGWRadio::startReception(cMessage *timer, IRadioSignal::SignalPart part)
 {
     auto radioFrame = static_cast<RadioFrame *>(timer->getControlInfo());
     auto arrival = radioFrame->getArrival();
-    auto reception = radioFrame->getReception();
     emit(LoRaGWRadioReceptionStarted, true);
     if (simTime() >= getSimulation()->getWarmupPeriod())
         LoRaGWRadioReceptionStarted_counter++;
     if (isReceiverMode(radioMode) && arrival->getStartTime(part) == simTime() && iAmTransmiting == false) {
         auto transmission = radioFrame->getTransmission();
         auto isReceptionAttempted = medium->isReceptionAttempted(this, transmission, part);
-        EV_INFO << "LoRaGWRadio Reception started: " << (isReceptionAttempted ? "attempting" : "not attempting") << " " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << " as " << reception << endl;
+        EV_INFO << "LoRaGWRadio Reception started: " << (isReceptionAttempted ? "attempting" : "not attempting") << " " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << endl;
         if (isReceptionAttempted) {
             if(iAmGateway) {
                 concurrentReceptions.push_back(timer);
@@ -160,13 +160,15 @@ void LoRaGWRadio::startReception(cMessage *timer, IRadioSignal::SignalPart part)
         }
     }
     else
-        EV_INFO << "LoRaGWRadio Reception started: ignoring " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << " as " << reception << endl;
+        EV_INFO << "LoRaGWRadio Reception started: ignoring " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << endl;
     timer->setKind(part);
     scheduleAt(arrival->getEndTime(part), timer);
     //updateTransceiverState();
     //updateTransceiverPart();
     radioMode = RADIO_MODE_TRANSCEIVER;
-    check_and_cast<LoRaMedium *>(medium)->emit(IRadioMedium::receptionStartedSignal, check_and_cast<const cObject *>(reception));
+    LoRaMedium *loRaMedium = check_and_cast<LoRaMedium *>(medium);
+    if (loRaMedium->mayHaveListeners(IRadioMedium::receptionStartedSignal))
+        loRaMedium->emit(IRadioMedium::receptionStartedSignal, check_and_cast<const cObject *>(radioFrame->getReception()));
     if(iAmGateway) EV << "[MSDebug] start reception, size : " << concurrentReceptions.size() << endl;
 }
 
@@ -176,7 +178,6 @@ void LoRaGWRadio::continueReception(cMessage *timer)
     auto nextPart = (IRadioSignal::SignalPart)(previousPart + 1);
     auto radioFrame = static_cast<RadioFrame *>(timer->getControlInfo());
     auto arrival = radioFrame->getArrival();
-    auto reception = radioFrame->getReception();
     if(iAmGateway) {
         std::list<cMessage *>::iterator it;
         for (it=concurrentReceptions.begin(); it!=concurrentReceptions.end(); it++) {
@@ -186,21 +187,21 @@ void LoRaGWRadio::continueReception(cMessage *timer)
     if (timer == receptionTimer && isReceiverMode(radioMode) && arrival->getEndTime(previousPart) == simTime() && iAmTransmiting == false) {
         auto transmission = radioFrame->getTransmission();
         bool isReceptionSuccessful = medium->isReceptionSuccessful(this, transmission, previousPart);
-        EV_INFO << "LoRaGWRadio Reception ended: " << (isReceptionSuccessful ? "successfully" : "unsuccessfully") << " for " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(previousPart) << " as " << reception << endl;
+        EV_INFO << "LoRaGWRadio Reception ended: " << (isReceptionSuccessful ? "successfully" : "unsuccessfully") << " for " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(previousPart) << endl;
         if (!isReceptionSuccessful) {
             receptionTimer = nullptr;
             if(iAmGateway) concurrentReceptions.remove(timer);
         }
         auto isReceptionAttempted = medium->isReceptionAttempted(this, transmission, nextPart);
-        EV_INFO << "LoRaGWRadio Reception started: " << (isReceptionAttempted ? "attempting" : "not attempting") << " " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(nextPart) << " as " << reception << endl;
+        EV_INFO << "LoRaGWRadio Reception started: " << (isReceptionAttempted ? "attempting" : "not attempting") << " " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(nextPart) << endl;
         if (!isReceptionAttempted) {
             receptionTimer = nullptr;
             if(iAmGateway) concurrentReceptions.remove(timer);
         }
     }
     else {
-        EV_INFO << "LoRaGWRadio Reception ended: ignoring " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(previousPart) << " as " << reception << endl;
-        EV_INFO << "LoRaGWRadio Reception started: ignoring " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(nextPart) << " as " << reception << endl;
+        EV_INFO << "LoRaGWRadio Reception ended: ignoring " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(previousPart) << endl;
+        EV_INFO << "LoRaGWRadio Reception started: ignoring " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(nextPart) << endl;
     }
     timer->setKind(nextPart);
     scheduleAt(arrival->getEndTime(nextPart), timer);
@@ -214,7 +215,6 @@ void LoRaGWRadio::endReception(cMessage *timer)
     auto part = (IRadioSignal::SignalPart)timer->getKind();
     auto radioFrame = static_cast<RadioFrame *>(timer->getControlInfo());
     auto arrival = radioFrame->getArrival();
-    auto reception = radioFrame->getReception();
     std::list<cMessage *>::iterator it;
     if(iAmGateway) {
         for (it=concurrentReceptions.begin(); it!=concurrentReceptions.end(); it++) {
@@ -225,7 +225,7 @@ void LoRaGWRadio::endReception(cMessage *timer)
         auto transmission = radioFrame->getTransmission();
 // TODO: this would draw twice from the random number generator in isReceptionSuccessful: auto isReceptionSuccessful = medium->isReceptionSuccessful(this, transmission, part);
         auto isReceptionSuccessful = medium->getReceptionDecision(this, radioFrame->getListening(), transmission, part)->isReceptionSuccessful();
-        EV_INFO << "LoRaGWRadio Reception ended (B): " << (isReceptionSuccessful ? "successfully" : "unsuccessfully") << " for " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << " as " << reception << endl;
+        EV_INFO << "LoRaGWRadio Reception ended (B): " << (isReceptionSuccessful ? "successfully" : "unsuccessfully") << " for " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << " as " << radioFrame->getReception() << endl;
         if(isReceptionSuccessful) {
             auto macFrame = medium->receivePacket(this, radioFrame);
             emit(LayeredProtocolBase::packetSentToUpperSignal, macFrame);
@@ -238,7 +238,7 @@ void LoRaGWRadio::endReception(cMessage *timer)
         if(iAmGateway) concurrentReceptions.remove(timer);
     }
     else {
-        EV_INFO << "LoRaGWRadio Reception ended: ignoring " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << " as " << reception << endl;
+        EV_INFO << "LoRaGWRadio Reception ended: ignoring " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << endl;
         EV_INFO << "LoRaGWRadio Reception ended: ignoring because timer == receptionTimer: " << timer << " == " << receptionTimer << endl;
         EV_INFO << "LoRaGWRadio Reception ended: ignoring because isReceiverMode(radioMode): " << isReceiverMode(radioMode) << endl;
         EV_INFO << "LoRaGWRadio Reception ended: ignoring because arrival->getEndTime() == simTime(): " << arrival->getEndTime() << " == " << simTime() << endl;
@@ -249,16 +249,29 @@ void LoRaGWRadio::endReception(cMessage *timer)
     //updateTransceiverState();
     //updateTransceiverPart();
     radioMode = RADIO_MODE_TRANSCEIVER;
-    check_and_cast<LoRaMedium *>(medium)->emit(IRadioMedium::receptionEndedSignal, check_and_cast<const cObject *>(reception));
+    LoRaMedium *loRaMedium = check_and_cast<LoRaMedium *>(medium);
+    if (loRaMedium->mayHaveListeners(IRadioMedium::receptionEndedSignal))
+        loRaMedium->emit(IRadioMedium::receptionEndedSignal, check_and_cast<const cObject *>(radioFrame->getReception()));
     delete timer;
 }
 
+void LoRaGWRadio::receiveFastModeFrame(cPacket *macFrame)
+{
+    Enter_Method_Silent();
+    take(macFrame);
+    EV_INFO << "LoRaGWRadio Reception ended: successfully (fast mode) for " << macFrame << endl;
+    emit(LayeredProtocolBase::packetSentToUpperSignal, macFrame);
+    emit(LoRaGWRadioReceptionFinishedCorrect, true);
+    if (simTime() >= getSimulation()->getWarmupPeriod())
+        LoRaGWRadioReceptionFinishedCorrect_counter++;
+    sendUp(macFrame);
+}
+
 void LoRaGWRadio::abortReception(cMessage *timer)
 {
     auto radioFrame = static_cast<RadioFrame *>(timer->getControlInfo());
     auto part = (IRadioSignal::SignalPart)timer->getKind();
-    auto reception = radioFrame->getReception();
-    EV_INFO << "LoRaGWRadio Reception aborted: for " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << " as " << reception << endl;
+    EV_INFO << "LoRaGWRadio Reception aborted: for " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << endl;
     if (timer == receptionTimer) {
         if(iAmGateway) concurrentReceptions.remove(timer);
         receptionTimer = nullptr;
@@ -20,11 +20,14 @@
 #include "inet/linklayer/common/UserPriority.h"
 #include "inet/linklayer/csmaca/CsmaCaMac.h"
 #include "LoRaMac.h"
+#include "misc/LoRaScalarCollector.h"
 
 namespace inet {
 
 Define_Module(LoRaMac);
 
+simsignal_t LoRaMac::macReadySignal = cComponent::registerSignal("macReady");
+
 LoRaMac::~LoRaMac()
 {
     cancelAndDelete(endTransmission);
@@ -127,14 +130,14 @@ void LoRaMac::initialize(int stage)
 
 void LoRaMac::finish()
 {
-    recordScalar("numRetry", numRetry);
-    recordScalar("numSentWithoutRetry", numSentWithoutRetry);
-    recordScalar("numGivenUp", numGivenUp);
+    LoRaScalarCollector::record(this, "numRetry", numRetry);
+    LoRaScalarCollector::record(this, "numSentWithoutRetry", numSentWithoutRetry);
+    LoRaScalarCollector::record(this, "numGivenUp", numGivenUp);
     //recordScalar("numCollision", numCollision);
-    recordScalar("numSent", numSent);
-    recordScalar("numReceived", numReceived);
-    recordScalar("numSentBroadcast", numSentBroadcast);
-    recordScalar("numReceivedBroadcast", numReceivedBroadcast);
+    LoRaScalarCollector::record(this, "numSent", numSent);
+    LoRaScalarCollector::record(this, "numReceived", numReceived);
+    LoRaScalarCollector::record(this, "numSentBroadcast", numSentBroadcast);
+    LoRaScalarCollector::record(this, "numReceivedBroadcast", numReceivedBroadcast);
 }
 
 InterfaceEntry *LoRaMac::createInterfaceEntry()
@@ -162,6 +165,30 @@ void LoRaMac::handleSelfMessage(cMessage *msg)
     handleWithFsm(msg);
 }
 
+bool LoRaMac::handleNodeStart(IDoneCallback *doneCallback)
+{
+    fsm.setState(IDLE, "IDLE");
+    retryCounter = 0;
+    radio->setRadioMode(IRadio::RADIO_MODE_RECEIVER);
+    return MACProtocolBase::handleNodeStart(doneCallback);
+}
+
+void LoRaMac::handleNodeCrash()
+{
+    // Self messages would be an error while the module is down
+    cancelEvent(endTransmission);
+    cancelEvent(endReception);
+    cancelEvent(droppedPacket);
+    cancelEvent(endDelay_1);
+    cancelEvent(endListening_1);
+    cancelEvent(endDelay_2);
+    cancelEvent(endListening_2);
+    cancelEvent(mediumStateChange);
+    transmissionQueue.clear();
+    fsm.setState(IDLE, "IDLE");
+    MACProtocolBase::handleNodeCrash();
+}
+
 void LoRaMac::handleUpperPacket(cPacket *msg)
 {
     if(fsm.getState() != IDLE)
@@ -177,7 +204,9 @@ void LoRaMac::handleUpperPacket(cPacket *msg)
     frame->setLoRaBW(cInfo->getLoRaBW());
     frame->setLoRaCR(cInfo->getLoRaCR());
     frame->setSequenceNumber(sequenceNumber);
-    frame->setReceiverAddress(DevAddr::BROADCAST_ADDRESS);
+    // Frames are broadcast unless the upper layer names a receiver, which lets
+    // the medium's MAC address filter deliver them to that radio only
+    frame->setReceiverAddress(cInfo->getDest().isUnspecified() ? DevAddr::BROADCAST_ADDRESS : cInfo->getDest());
     ++sequenceNumber;
     frame->setLoRaUseHeader(cInfo->getLoRaUseHeader());
     EV << "frame " << frame << " received from higher layer, receiver = " << frame->getReceiverAddress() << endl;
@@ -211,7 +240,8 @@ void LoRaMac::handleWithFsm(cMessage *msg)
         FSMA_State(IDLE)
         {
             EV_INFO << "handling packet with handleWithFsm(): IDLE" << endl;
-            FSMA_Enter(turnOffReceiver());
+            // Notify the application that a parked transmission may now be handed down
+            FSMA_Enter(turnOffReceiver(); emit(macReadySignal, true));
             FSMA_Event_Transition(Idle-Transmit,
                                   isUpperMessage(msg),
                                   TRANSMIT,
@@ -346,6 +376,14 @@ void LoRaMac::handleWithFsm(cMessage *msg)
 void LoRaMac::receiveSignal(cComponent *source, simsignal_t signalID, long value, cObject *details)
 {
     Enter_Method_Silent();
+    if (!isOperational) {
+        // The radio of a crashed node switching off must not restart the FSM
+        if (signalID == IRadio::receptionStateChangedSignal)
+            receptionState = (IRadio::ReceptionState)value;
+        else if (signalID == IRadio::transmissionStateChangedSignal)
+            transmissionState = (IRadio::TransmissionState)value;
+        return;
+    }
     if (signalID == IRadio::receptionStateChangedSignal) {
         IRadio::ReceptionState newRadioReceptionState = (IRadio::ReceptionState)value;
         if (receptionState == IRadio::RECEPTION_STATE_RECEIVING) {
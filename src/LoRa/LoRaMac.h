@@ -133,6 +133,9 @@ class LoRaMac : public MACProtocolBase
 
     cFSM fsm;
 
+    /** Emitted each time the FSM (re-)enters IDLE, i.e. when a new upper packet can be accepted */
+    static simsignal_t macReadySignal;
+
   protected:
     /**
      * @name Initialization functions
@@ -154,6 +157,9 @@ class LoRaMac : public MACProtocolBase
     virtual void handleLowerPacket(cPacket *msg) override;
     virtual void handleWithFsm(cMessage *msg);
 
+    virtual bool handleNodeStart(IDoneCallback *doneCallback) override;
+    virtual void handleNodeCrash() override;
+
     virtual void receiveSignal(cComponent *source, simsignal_t signalID, long value, cObject *details) override;
 
     virtual LoRaMacFrame *encapsulate(cPacket *msg);
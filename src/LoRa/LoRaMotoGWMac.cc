@@ -14,6 +14,7 @@
 // 
 
 #include "LoRaMotoGWMac.h"
+#include "misc/LoRaScalarCollector.h"
 #include "inet/common/ModuleAccess.h"
 #include "inet/physicallayer/contract/packetlevel/IRadio.h"
 
@@ -52,8 +53,8 @@ void LoRaMotoGWMac::initialize(int stage)
 
 void LoRaMotoGWMac::finish()
 {
-    recordScalar("GW_forwardedDown", GW_forwardedDown);
-    recordScalar("GW_droppedDC", GW_droppedDC);
+    LoRaScalarCollector::record(this, "GW_forwardedDown", GW_forwardedDown);
+    LoRaScalarCollector::record(this, "GW_droppedDC", GW_droppedDC);
     cancelAndDelete(dutyCycleTimer);
 }
 
@@ -14,6 +14,7 @@
 // 
 
 #include "LoRaMotoGWRadio.h"
+#include "misc/LoRaScalarCollector.h"
 #include "LoRaPhy/LoRaMedium.h"
 
 namespace inet {
@@ -40,7 +41,7 @@ void LoRaMotoGWRadio::finish()
 {
     FlatRadioBase::finish();
     EV_INFO << "Correct finished radio reception count = " << LoRaMotoGWRadioReceptionFinishedCorrect_counter << endl;
-    recordScalar("DER - Data Extraction Rate", double(LoRaMotoGWRadioReceptionFinishedCorrect_counter)/LoRaMotoGWRadioReceptionStarted_counter);
+    LoRaScalarCollector::record(this, "DER - Data Extraction Rate", double(LoRaMotoGWRadioReceptionFinishedCorrect_counter)/LoRaMotoGWRadioReceptionStarted_counter);
 }
 
 void LoRaMotoGWRadio::handleSelfMessage(cMessage *message)
@@ -145,14 +146,13 @@ void LoRaMotoGWRadio::startReception(cMessage *timer, IRadioSignal::SignalPart p
 {
     auto radioFrame = static_cast<RadioFrame *>(timer->getControlInfo());
     auto arrival = radioFrame->getArrival();
-    auto reception = radioFrame->getReception();
     emit(LoRaMotoGWRadioReceptionStarted, true);
     if (simTime() >= getSimulation()->getWarmupPeriod())
         LoRaMotoGWRadioReceptionStarted_counter++;
     if (isReceiverMode(radioMode) && arrival->getStartTime(part) == simTime() && iAmTransmiting == false) {
         auto transmission = radioFrame->getTransmission();
         auto isReceptionAttempted = medium->isReceptionAttempted(this, transmission, part);
-        EV_INFO << "LoRaMotoGWRadio Reception started: " << (isReceptionAttempted ? "attempting" : "not attempting") << " " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << " as " << reception << endl;
+        EV_INFO << "LoRaMotoGWRadio Reception started: " << (isReceptionAttempted ? "attempting" : "not attempting") << " " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << endl;
         if (isReceptionAttempted) {
             if(iAmGateway) {
                 concurrentReceptions.push_back(timer);
@@ -161,13 +161,15 @@ void LoRaMotoGWRadio::startReception(cMessage *timer, IRadioSignal::SignalPart p
         }
     }
     else
-        EV_INFO << "LoRaMotoGWRadio Reception started: ignoring " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << " as " << reception << endl;
+        EV_INFO << "LoRaMotoGWRadio Reception started: ignoring " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << endl;
     timer->setKind(part);
     scheduleAt(arrival->getEndTime(part), timer);
     //updateTransceiverState();
     //updateTransceiverPart();
     radioMode = RADIO_MODE_TRANSCEIVER;
-    check_and_cast<LoRaMedium *>(medium)->emit(IRadioMedium::receptionStartedSignal, check_and_cast<const cObject *>(reception));
+    LoRaMedium *loRaMedium = check_and_cast<LoRaMedium *>(medium);
+    if (loRaMedium->mayHaveListeners(IRadioMedium::receptionStartedSignal))
+        loRaMedium->emit(IRadioMedium::receptionStartedSignal, check_and_cast<const cObject *>(radioFrame->getReception()));
     if(iAmGateway) EV << "[MSDebug] start reception, size : " << concurrentReceptions.size() << endl;
 }
 
@@ -177,7 +179,6 @@ void LoRaMotoGWRadio::continueReception(cMessage *timer)
     auto nextPart = (IRadioSignal::SignalPart)(previousPart + 1);
     auto radioFrame = static_cast<RadioFrame *>(timer->getControlInfo());
     auto arrival = radioFrame->getArrival();
-    auto reception = radioFrame->getReception();
     if(iAmGateway) {
         std::list<cMessage *>::iterator it;
         for (it=concurrentReceptions.begin(); it!=concurrentReceptions.end(); it++) {
@@ -188,21 +189,21 @@ void LoRaMotoGWRadio::continueReception(cMessage *timer)
 
         auto transmission = radioFrame->getTransmission();
         bool isReceptionSuccessful = medium->isReceptionSuccessful(this, transmission, previousPart);
-        EV_INFO << "LoRaMotoGWRadio 00 Reception ended: " << (isReceptionSuccessful ? "successfully" : "unsuccessfully") << " for " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(previousPart) << " as " << reception << endl;
+        EV_INFO << "LoRaMotoGWRadio 00 Reception ended: " << (isReceptionSuccessful ? "successfully" : "unsuccessfully") << " for " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(previousPart) << endl;
         if (!isReceptionSuccessful) {
             receptionTimer = nullptr;
             if(iAmGateway) concurrentReceptions.remove(timer);
         }
         auto isReceptionAttempted = medium->isReceptionAttempted(this, transmission, nextPart);
-        EV_INFO << "LoRaMotoGWRadio Reception started: " << (isReceptionAttempted ? "attempting" : "not attempting") << " " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(nextPart) << " as " << reception << endl;
+        EV_INFO << "LoRaMotoGWRadio Reception started: " << (isReceptionAttempted ? "attempting" : "not attempting") << " " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(nextPart) << endl;
         if (!isReceptionAttempted) {
             receptionTimer = nullptr;
             if(iAmGateway) concurrentReceptions.remove(timer);
         }
     }
     else {
-        EV_INFO << "LoRaMotoGWRadio Reception ended: ignoring " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(previousPart) << " as " << reception << endl;
-        EV_INFO << "LoRaMotoGWRadio Reception started: ignoring " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(nextPart) << " as " << reception << endl;
+        EV_INFO << "LoRaMotoGWRadio Reception ended: ignoring " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(previousPart) << endl;
+        EV_INFO << "LoRaMotoGWRadio Reception started: ignoring " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(nextPart) << endl;
     }
     timer->setKind(nextPart);
     scheduleAt(arrival->getEndTime(nextPart), timer);
@@ -216,7 +217,6 @@ void LoRaMotoGWRadio::endReception(cMessage *timer)
     auto part = (IRadioSignal::SignalPart)timer->getKind();
     auto radioFrame = static_cast<RadioFrame *>(timer->getControlInfo());
     auto arrival = radioFrame->getArrival();
-    auto reception = radioFrame->getReception();
     std::list<cMessage *>::iterator it;
     if(iAmGateway) {
         for (it=concurrentReceptions.begin(); it!=concurrentReceptions.end(); it++) {
@@ -228,7 +228,7 @@ void LoRaMotoGWRadio::endReception(cMessage *timer)
 // TODO: this would draw twice from the random number generator in isReceptionSuccessful: auto isReceptionSuccessful = medium->isReceptionSuccessful(this, transmission, part);
         auto isReceptionSuccessful = medium->getReceptionDecision(this, radioFrame->getListening(), transmission, part)->isReceptionSuccessful();
         isReceptionSuccessful = true;
-        EV_INFO << "LoRaMotoGWRadio 01 Reception ended: " << (isReceptionSuccessful ? "successfully" : "unsuccessfully") << " for " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << " as " << reception << endl;
+        EV_INFO << "LoRaMotoGWRadio 01 Reception ended: " << (isReceptionSuccessful ? "successfully" : "unsuccessfully") << " for " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << endl;
         if(isReceptionSuccessful) {
             auto macFrame = medium->receivePacket(this, radioFrame);
             emit(LayeredProtocolBase::packetSentToUpperSignal, macFrame);
@@ -241,20 +241,33 @@ void LoRaMotoGWRadio::endReception(cMessage *timer)
         if(iAmGateway) concurrentReceptions.remove(timer);
     }
     else
-        EV_INFO << "LoRaMotoGWRadio Reception ended: ignoring " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << " as " << reception << endl;
+        EV_INFO << "LoRaMotoGWRadio Reception ended: ignoring " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << endl;
     //updateTransceiverState();
     //updateTransceiverPart();
     radioMode = RADIO_MODE_TRANSCEIVER;
-    check_and_cast<LoRaMedium *>(medium)->emit(IRadioMedium::receptionEndedSignal, check_and_cast<const cObject *>(reception));
+    LoRaMedium *loRaMedium = check_and_cast<LoRaMedium *>(medium);
+    if (loRaMedium->mayHaveListeners(IRadioMedium::receptionEndedSignal))
+        loRaMedium->emit(IRadioMedium::receptionEndedSignal, check_and_cast<const cObject *>(radioFrame->getReception()));
     delete timer;
 }
 
+void LoRaMotoGWRadio::receiveFastModeFrame(cPacket *macFrame)
+{
+    Enter_Method_Silent();
+    take(macFrame);
+    EV_INFO << "LoRaMotoGWRadio Reception ended: successfully (fast mode) for " << macFrame << endl;
+    emit(LayeredProtocolBase::packetSentToUpperSignal, macFrame);
+    emit(LoRaMotoGWRadioReceptionFinishedCorrect, true);
+    if (simTime() >= getSimulation()->getWarmupPeriod())
+        LoRaMotoGWRadioReceptionFinishedCorrect_counter++;
+    sendUp(macFrame);
+}
+
 void LoRaMotoGWRadio::abortReception(cMessage *timer)
 {
     auto radioFrame = static_cast<RadioFrame *>(timer->getControlInfo());
     auto part = (IRadioSignal::SignalPart)timer->getKind();
-    auto reception = radioFrame->getReception();
-    EV_INFO << "LoRaMotoGWRadio Reception aborted: for " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << " as " << reception << endl;
+    EV_INFO << "LoRaMotoGWRadio Reception aborted: for " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << endl;
     if (timer == receptionTimer) {
         if(iAmGateway) concurrentReceptions.remove(timer);
         receptionTimer = nullptr;
@@ -56,6 +56,8 @@ protected:
 
 public:
     bool iAmGateway;
+    // Delivers a frame the fast mode medium decided to be received, see LoRaRadio::receiveFastModeFrame
+    virtual void receiveFastModeFrame(cPacket *macFrame);
 
     std::list<cMessage *>concurrentReceptions;
     std::list<cMessage *>concurrentTransmissions;
@@ -320,6 +320,7 @@ bool LoRaRadio::handleNodeStart(IDoneCallback *doneCallback)
 {
     // NOTE: we ignore radio mode switching during start
     completeRadioModeSwitch(RADIO_MODE_OFF);
+    check_and_cast<LoRaMedium *>(medium)->attachRadio(this);
     return PhysicalLayerBase::handleNodeStart(doneCallback);
 }
 
@@ -330,6 +331,8 @@ bool LoRaRadio::handleNodeShutdown(IDoneCallback *doneCallback)
     if (transmissionTimer->isScheduled())
         abortTransmission();
     completeRadioModeSwitch(RADIO_MODE_OFF);
+    // A node that is down does not cost the medium any PHY work
+    check_and_cast<LoRaMedium *>(medium)->detachRadio(this);
     return PhysicalLayerBase::handleNodeShutdown(doneCallback);
 }
 
@@ -339,6 +342,7 @@ void LoRaRadio::handleNodeCrash()
     if (transmissionTimer->isScheduled())
         abortTransmission();
     completeRadioModeSwitch(RADIO_MODE_OFF);
+    check_and_cast<LoRaMedium *>(medium)->detachRadio(this);
     PhysicalLayerBase::handleNodeCrash();
 }
 
@@ -408,19 +412,18 @@ void LoRaRadio::startReception(cMessage *timer, IRadioSignal::SignalPart part)
 {
     auto radioFrame = static_cast<RadioFrame *>(timer->getControlInfo());
     auto arrival = radioFrame->getArrival();
-    auto reception = radioFrame->getReception();
 // TODO: should be this, but it breaks fingerprints: if (receptionTimer == nullptr && isReceiverMode(radioMode) && arrival->getStartTime(part) == simTime()) {
     if (isReceiverMode(radioMode) && arrival->getStartTime(part) == simTime()) {
         auto transmission = radioFrame->getTransmission();
         auto isReceptionAttempted = medium->isReceptionAttempted(this, transmission, part);
-        EV_INFO << "Reception started: (A): " << (isReceptionAttempted ? "attempting" : "not attempting") << " " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << " as " << reception << endl;
+        EV_INFO << "Reception started: (A): " << (isReceptionAttempted ? "attempting" : "not attempting") << " " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << endl;
         if (isReceptionAttempted)
         {
             receptionTimer = timer;
         }
     }
     else {
-        EV_INFO << "Reception started: ignoring (A) " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << " as " << reception << endl;
+        EV_INFO << "Reception started: ignoring (A) " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << endl;
         EV_INFO << "Reception started: ignoring (A): isReceiverMode(radioMode): " << isReceiverMode(radioMode) << endl;
         if ( !isReceiverMode(radioMode)) {
             EV_INFO << "Reception started: ignoring (A): radioMode: " << radioMode << endl;
@@ -431,7 +434,10 @@ void LoRaRadio::startReception(cMessage *timer, IRadioSignal::SignalPart part)
     updateTransceiverState();
     updateTransceiverPart();
     //check_and_cast<LoRaMedium *>(medium)->fireReceptionStarted(reception);
-    check_and_cast<LoRaMedium *>(medium)->emit(IRadioMedium::receptionStartedSignal, check_and_cast<const cObject *>(reception));
+    // Only attempted receptions are computed otherwise, so the frame is resolved for listeners alone
+    LoRaMedium *loRaMedium = check_and_cast<LoRaMedium *>(medium);
+    if (loRaMedium->mayHaveListeners(IRadioMedium::receptionStartedSignal))
+        loRaMedium->emit(IRadioMedium::receptionStartedSignal, check_and_cast<const cObject *>(radioFrame->getReception()));
 }
 
 void LoRaRadio::continueReception(cMessage *timer)
@@ -440,25 +446,24 @@ void LoRaRadio::continueReception(cMessage *timer)
     auto nextPart = (IRadioSignal::SignalPart)(previousPart + 1);
     auto radioFrame = static_cast<RadioFrame *>(timer->getControlInfo());
     auto arrival = radioFrame->getArrival();
-    auto reception = radioFrame->getReception();
     if (timer == receptionTimer && isReceiverMode(radioMode) && arrival->getEndTime(previousPart) == simTime()) {
         auto transmission = radioFrame->getTransmission();
         bool isReceptionSuccessful = medium->isReceptionSuccessful(this, transmission, previousPart);
-        EV_INFO << "Reception ended: " << (isReceptionSuccessful ? "successfully" : "unsuccessfully") << " for " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(previousPart) << " as " << reception << endl;
+        EV_INFO << "Reception ended: " << (isReceptionSuccessful ? "successfully" : "unsuccessfully") << " for " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(previousPart) << endl;
         if (!isReceptionSuccessful)
         {
             receptionTimer = nullptr;
         }
         auto isReceptionAttempted = medium->isReceptionAttempted(this, transmission, nextPart);
-        EV_INFO << "Reception started: " << (isReceptionAttempted ? "attempting" : "not attempting") << " " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(nextPart) << " as " << reception << endl;
+        EV_INFO << "Reception started: " << (isReceptionAttempted ? "attempting" : "not attempting") << " " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(nextPart) << endl;
         if (!isReceptionAttempted)
         {
             receptionTimer = nullptr;
         }
     }
     else {
-        EV_INFO << "Reception ended: ignoring " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(previousPart) << " as " << reception << endl;
-        EV_INFO << "Reception started: ignoring (B)" << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(nextPart) << " as " << reception << endl;
+        EV_INFO << "Reception ended: ignoring " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(previousPart) << endl;
+        EV_INFO << "Reception started: ignoring (B)" << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(nextPart) << endl;
     }
     timer->setKind(nextPart);
     scheduleAt(arrival->getEndTime(nextPart), timer);
@@ -471,12 +476,12 @@ void LoRaRadio::endReception(cMessage *timer)
     auto part = (IRadioSignal::SignalPart)timer->getKind();
     auto radioFrame = static_cast<RadioFrame *>(timer->getControlInfo());
     auto arrival = radioFrame->getArrival();
-    auto reception = radioFrame->getReception();
     if (timer == receptionTimer && isReceiverMode(radioMode) && arrival->getEndTime() == simTime()) {
     //if (isReceiverMode(radioMode) && arrival->getEndTime() == simTime()) {
         auto transmission = radioFrame->getTransmission();
 // TODO: this would draw twice from the random number generator in isReceptionSuccessful: auto isReceptionSuccessful = medium->isReceptionSuccessful(this, transmission, part);
         auto isReceptionSuccessful = medium->getReceptionDecision(this, radioFrame->getListening(), transmission, part)->isReceptionSuccessful();
+        auto reception = radioFrame->getReception();
         EV_INFO << "Reception ended: " << (isReceptionSuccessful ? "successfully" : "unsuccessfully") << " for " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << " as " << reception << endl;
         auto macFrame = medium->receivePacket(this, radioFrame);
 
@@ -505,7 +510,7 @@ void LoRaRadio::endReception(cMessage *timer)
         receptionTimer = nullptr;
     }
     else {
-        EV_INFO << "Reception ended: ignoring (A)" << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << " as " << reception << endl;
+        EV_INFO << "Reception ended: ignoring (A)" << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << endl;
         EV_INFO << "Reception ended: ignoring (A): timer == receptionTimer: " << timer << " " << receptionTimer << endl;
         EV_INFO << "Reception ended: ignoring (A): isReceiverMode(radioMode): " << isReceiverMode(radioMode) << endl;
             if ( !isReceiverMode(radioMode)) {
@@ -517,7 +522,9 @@ void LoRaRadio::endReception(cMessage *timer)
     updateTransceiverState();
     updateTransceiverPart();
     //check_and_cast<LoRaMedium *>(medium)->fireReceptionEnded(reception);
-    check_and_cast<LoRaMedium *>(medium)->emit(IRadioMedium::receptionEndedSignal, check_and_cast<const cObject *>(reception));
+    LoRaMedium *loRaMedium = check_and_cast<LoRaMedium *>(medium);
+    if (loRaMedium->mayHaveListeners(IRadioMedium::receptionEndedSignal))
+        loRaMedium->emit(IRadioMedium::receptionEndedSignal, check_and_cast<const cObject *>(radioFrame->getReception()));
     delete timer;
 }
 
@@ -525,8 +532,7 @@ void LoRaRadio::abortReception(cMessage *timer)
 {
     auto radioFrame = static_cast<RadioFrame *>(timer->getControlInfo());
     auto part = (IRadioSignal::SignalPart)timer->getKind();
-    auto reception = radioFrame->getReception();
-    EV_INFO << "Reception aborted: for " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << " as " << reception << endl;
+    EV_INFO << "Reception aborted: for " << (IRadioFrame *)radioFrame << " " << IRadioSignal::getSignalPartName(part) << endl;
     if (timer == receptionTimer)
     {
         receptionTimer = nullptr;
@@ -535,6 +541,15 @@ void LoRaRadio::abortReception(cMessage *timer)
     updateTransceiverPart();
 }
 
+void LoRaRadio::receiveFastModeFrame(cPacket *macFrame)
+{
+    Enter_Method_Silent();
+    take(macFrame);
+    EV_INFO << "Reception ended: successfully (fast mode) for " << macFrame << endl;
+    emit(LayeredProtocolBase::packetSentToUpperSignal, macFrame);
+    sendUp(macFrame);
+}
+
 void LoRaRadio::captureReception(cMessage *timer)
 {
     // TODO: this would be called when the receiver switches to a stronger signal while receiving a weaker one
@@ -202,6 +202,11 @@ class INET_API LoRaRadio : public FlatRadioBase //: public PhysicalLayerBase, pu
     bool iAmGateway;
     double getCurrentTxPower();
     void setCurrentTxPower(double txPower);
+    /**
+     * Hands a frame that the fast mode medium already decided to be
+     * successfully received to the MAC, without reception timers.
+     */
+    virtual void receiveFastModeFrame(cPacket *macFrame);
 
     std::list<cMessage *>concurrentReceptions;
 
@@ -14,6 +14,7 @@
 // 
 
 #include "NetworkServerApp.h"
+#include "misc/LoRaScalarCollector.h"
 #include "inet/networklayer/ipv4/IPv4Datagram.h"
 #include "inet/networklayer/contract/ipv4/IPv4ControlInfo.h"
 #include "inet/networklayer/common/L3AddressResolver.h"
@@ -103,70 +104,71 @@ void NetworkServerApp::processLoraMACPacket(cPacket *pk)
 
 void NetworkServerApp::finish()
 {
-    recordScalar("LoRa_NS_DER", double(counterUniqueReceivedPackets)/counterOfSentPacketsFromNodes);
+    LoRaScalarCollector::record(this, "LoRa_NS_DER", double(counterUniqueReceivedPackets)/counterOfSentPacketsFromNodes);
     for(uint i=0;i<knownNodes.size();i++)
     {
         delete knownNodes[i].historyAllSNIR;
         delete knownNodes[i].historyAllRSSI;
         delete knownNodes[i].receivedSeqNumber;
         delete knownNodes[i].calculatedSNRmargin;
-        recordScalar("Send ADR for node", knownNodes[i].numberOfSentADRPackets);
-        recordScalar("Send ACK for node", knownNodes[i].numberOfSentACKPackets);
+        const std::string nodeAddress = knownNodes[i].srcAddr.str();
+        LoRaScalarCollector::record(this, "Send ADR for node " + nodeAddress, knownNodes[i].numberOfSentADRPackets);
+        LoRaScalarCollector::record(this, "Send ACK for node " + nodeAddress, knownNodes[i].numberOfSentACKPackets);
     }
     for (std::map<int,int>::iterator it=numReceivedPerNode.begin(); it != numReceivedPerNode.end(); ++it)
     {
         const std::string stringScalar = "numReceivedFromNode " + std::to_string(it->first);
-        recordScalar(stringScalar.c_str(), it->second);
+        LoRaScalarCollector::record(this, stringScalar.c_str(), it->second);
     }
 
-    receivedRSSI.recordAs("receivedRSSI");
-    recordScalar("totalReceivedPackets", totalReceivedPackets);
+    LoRaScalarCollector::record(this, "receivedRSSI", receivedRSSI);
+    LoRaScalarCollector::record(this, "totalReceivedPackets", totalReceivedPackets);
     for(uint i=0;i<receivedPackets.size();i++)
     {
         delete receivedPackets[i].rcvdPacket;
     }
-    recordScalar("counterUniqueReceivedPacketsPerSF SF7", counterUniqueReceivedPacketsPerSF[0]);
-    recordScalar("counterUniqueReceivedPacketsPerSF SF8", counterUniqueReceivedPacketsPerSF[1]);
-    recordScalar("counterUniqueReceivedPacketsPerSF SF9", counterUniqueReceivedPacketsPerSF[2]);
-    recordScalar("counterUniqueReceivedPacketsPerSF SF10", counterUniqueReceivedPacketsPerSF[3]);
-    recordScalar("counterUniqueReceivedPacketsPerSF SF11", counterUniqueReceivedPacketsPerSF[4]);
-    recordScalar("counterUniqueReceivedPacketsPerSF SF12", counterUniqueReceivedPacketsPerSF[5]);
+    LoRaScalarCollector::record(this, "counterUniqueReceivedPacketsPerSF SF7", counterUniqueReceivedPacketsPerSF[0]);
+    LoRaScalarCollector::record(this, "counterUniqueReceivedPacketsPerSF SF8", counterUniqueReceivedPacketsPerSF[1]);
+    LoRaScalarCollector::record(this, "counterUniqueReceivedPacketsPerSF SF9", counterUniqueReceivedPacketsPerSF[2]);
+    LoRaScalarCollector::record(this, "counterUniqueReceivedPacketsPerSF SF10", counterUniqueReceivedPacketsPerSF[3]);
+    LoRaScalarCollector::record(this, "counterUniqueReceivedPacketsPerSF SF11", counterUniqueReceivedPacketsPerSF[4]);
+    LoRaScalarCollector::record(this, "counterUniqueReceivedPacketsPerSF SF12", counterUniqueReceivedPacketsPerSF[5]);
     if (counterOfSentPacketsFromNodesPerSF[0] > 0)
-        recordScalar("DER SF7", double(counterUniqueReceivedPacketsPerSF[0]) / counterOfSentPacketsFromNodesPerSF[0]);
+        LoRaScalarCollector::record(this, "DER SF7", double(counterUniqueReceivedPacketsPerSF[0]) / counterOfSentPacketsFromNodesPerSF[0]);
     else
-        recordScalar("DER SF7", 0);
+        LoRaScalarCollector::record(this, "DER SF7", 0);
 
     if (counterOfSentPacketsFromNodesPerSF[1] > 0)
-        recordScalar("DER SF8", double(counterUniqueReceivedPacketsPerSF[1]) / counterOfSentPacketsFromNodesPerSF[1]);
+        LoRaScalarCollector::record(this, "DER SF8", double(counterUniqueReceivedPacketsPerSF[1]) / counterOfSentPacketsFromNodesPerSF[1]);
     else
-        recordScalar("DER SF8", 0);
+        LoRaScalarCollector::record(this, "DER SF8", 0);
 
     if (counterOfSentPacketsFromNodesPerSF[2] > 0)
-        recordScalar("DER SF9", double(counterUniqueReceivedPacketsPerSF[2]) / counterOfSentPacketsFromNodesPerSF[2]);
+        LoRaScalarCollector::record(this, "DER SF9", double(counterUniqueReceivedPacketsPerSF[2]) / counterOfSentPacketsFromNodesPerSF[2]);
     else
-        recordScalar("DER SF9", 0);
+        LoRaScalarCollector::record(this, "DER SF9", 0);
 
     if (counterOfSentPacketsFromNodesPerSF[3] > 0)
-        recordScalar("DER SF10", double(counterUniqueReceivedPacketsPerSF[3]) / counterOfSentPacketsFromNodesPerSF[3]);
+        LoRaScalarCollector::record(this, "DER SF10", double(counterUniqueReceivedPacketsPerSF[3]) / counterOfSentPacketsFromNodesPerSF[3]);
     else
-        recordScalar("DER SF10", 0);
+        LoRaScalarCollector::record(this, "DER SF10", 0);
 
     if (counterOfSentPacketsFromNodesPerSF[4] > 0)
-        recordScalar("DER SF11", double(counterUniqueReceivedPacketsPerSF[4]) / counterOfSentPacketsFromNodesPerSF[4]);
+        LoRaScalarCollector::record(this, "DER SF11", double(counterUniqueReceivedPacketsPerSF[4]) / counterOfSentPacketsFromNodesPerSF[4]);
     else
-        recordScalar("DER SF11", 0);
+        LoRaScalarCollector::record(this, "DER SF11", 0);
 
     if (counterOfSentPacketsFromNodesPerSF[5] > 0)
-        recordScalar("DER SF12", double(counterUniqueReceivedPacketsPerSF[5]) / counterOfSentPacketsFromNodesPerSF[5]);
+        LoRaScalarCollector::record(this, "DER SF12", double(counterUniqueReceivedPacketsPerSF[5]) / counterOfSentPacketsFromNodesPerSF[5]);
     else
-        recordScalar("DER SF12", 0);
+        LoRaScalarCollector::record(this, "DER SF12", 0);
 
-    recordScalar("allReceivedNodes", allReceivedNodes.size());
-    recordScalar("directReceivedNodes", directReceivedNodes.size());
-    recordScalar("forwardedNodes", forwardedNodes.size());
-    recordScalar("forwardingNodes", forwardingNodes.size());
-    recordScalar("ACKReqNodes", ACKReqNodes.size());
-    recordScalar("ACKedNodes", ACKedNodes.size());
+    LoRaScalarCollector::record(this, "allReceivedNodes", allReceivedNodes.size());
+    LoRaScalarCollector::record(this, "directReceivedNodes", directReceivedNodes.size());
+    LoRaScalarCollector::record(this, "forwardedNodes", forwardedNodes.size());
+    LoRaScalarCollector::record(this, "forwardingNodes", forwardingNodes.size());
+    LoRaScalarCollector::record(this, "ACKReqNodes", ACKReqNodes.size());
+    LoRaScalarCollector::record(this, "ACKedNodes", ACKedNodes.size());
 
     std::vector<int> directOnlyNodes;
     std::vector<int> forwardedOnlyNodes;
@@ -180,8 +182,8 @@ void NetworkServerApp::finish()
         }
     }
 
-    recordScalar("directOnlyNodes", directOnlyNodes.size());
-    recordScalar("forwardedOnlyNodes", forwardedOnlyNodes.size());
+    LoRaScalarCollector::record(this, "directOnlyNodes", directOnlyNodes.size());
+    LoRaScalarCollector::record(this, "forwardedOnlyNodes", forwardedOnlyNodes.size());
 }
 
 bool NetworkServerApp::isPacketProcessed(LoRaMacFrame* pkt)
@@ -14,6 +14,7 @@
 // 
 
 #include "PacketForwarder.h"
+#include "misc/LoRaScalarCollector.h"
 #include "inet/networklayer/ipv4/IPv4Datagram.h"
 #include "inet/networklayer/contract/ipv4/IPv4ControlInfo.h"
 #include "inet/networklayer/common/L3AddressResolver.h"
@@ -139,7 +140,7 @@ void PacketForwarder::receiveSignal(cComponent *source, simsignal_t signalID, lo
 
 void PacketForwarder::finish()
 {
-    recordScalar("LoRa_GW_DER", double(counterOfReceivedPackets)/counterOfSentPacketsFromNodes);
+    LoRaScalarCollector::record(this, "LoRa_GW_DER", double(counterOfReceivedPackets)/counterOfSentPacketsFromNodes);
 }
 
 
@@ -24,6 +24,7 @@
 //
 
 #include "LoRaEndNodeApp.h"
+#include "misc/LoRaScalarCollector.h"
 #include "inet/common/FSMA.h"
 #include "../LoRa/LoRaMac.h"
 
@@ -475,64 +476,64 @@ void LoRaEndNodeApp::finish() {
         } else if (mobMod->hasPar("initialX") && mobMod->hasPar("initialY")) {
             coord = Coord(mobMod->par("initialX").doubleValue(), mobMod->par("initialY").doubleValue(), 0);
         }
-        recordScalar("positionX", coord.x);
-        recordScalar("positionY", coord.y);
+        LoRaScalarCollector::record(this, "positionX", coord.x);
+        LoRaScalarCollector::record(this, "positionY", coord.y);
     }
-    recordScalar("finalTP", loRaTP);
-    recordScalar("finalSF", loRaSF);
-
-    recordScalar("sentPackets", sentPackets);
-    recordScalar("sentDataPackets", sentDataPackets);
-    recordScalar("sentRoutingPackets", sentRoutingPackets);
-    recordScalar("sentAckPackets", sentAckPackets);
-    recordScalar("receivedPackets", receivedPackets);
-    recordScalar("receivedPacketsForMe", receivedPacketsForMe);
-    recordScalar("receivedPacketsFromMe", receivedPacketsFromMe);
-    recordScalar("receivedPacketsToForward", receivedPacketsToForward);
-    recordScalar("receivedDataPackets", receivedDataPackets);
-    recordScalar("receivedDataPacketsForMe", receivedDataPacketsForMe);
-    recordScalar("receivedDataPacketsForMeUnique", receivedDataPacketsForMeUnique);
-    recordScalar("receivedDataPacketsFromMe", receivedDataPacketsFromMe);
-    recordScalar("receivedDataPacketsToForward", receivedDataPacketsToForward);
-    recordScalar("receivedDataPacketsToForwardCorrect",
+    LoRaScalarCollector::record(this, "finalTP", loRaTP);
+    LoRaScalarCollector::record(this, "finalSF", loRaSF);
+
+    LoRaScalarCollector::record(this, "sentPackets", sentPackets);
+    LoRaScalarCollector::record(this, "sentDataPackets", sentDataPackets);
+    LoRaScalarCollector::record(this, "sentRoutingPackets", sentRoutingPackets);
+    LoRaScalarCollector::record(this, "sentAckPackets", sentAckPackets);
+    LoRaScalarCollector::record(this, "receivedPackets", receivedPackets);
+    LoRaScalarCollector::record(this, "receivedPacketsForMe", receivedPacketsForMe);
+    LoRaScalarCollector::record(this, "receivedPacketsFromMe", receivedPacketsFromMe);
+    LoRaScalarCollector::record(this, "receivedPacketsToForward", receivedPacketsToForward);
+    LoRaScalarCollector::record(this, "receivedDataPackets", receivedDataPackets);
+    LoRaScalarCollector::record(this, "receivedDataPacketsForMe", receivedDataPacketsForMe);
+    LoRaScalarCollector::record(this, "receivedDataPacketsForMeUnique", receivedDataPacketsForMeUnique);
+    LoRaScalarCollector::record(this, "receivedDataPacketsFromMe", receivedDataPacketsFromMe);
+    LoRaScalarCollector::record(this, "receivedDataPacketsToForward", receivedDataPacketsToForward);
+    LoRaScalarCollector::record(this, "receivedDataPacketsToForwardCorrect",
             receivedDataPacketsToForwardCorrect);
-    recordScalar("receivedDataPacketsToForwardExpired",
+    LoRaScalarCollector::record(this, "receivedDataPacketsToForwardExpired",
             receivedDataPacketsToForwardExpired);
-    recordScalar("receivedDataPacketsToForwardUnique",
+    LoRaScalarCollector::record(this, "receivedDataPacketsToForwardUnique",
             receivedDataPacketsToForwardUnique);
-    recordScalar("receivedAckPacketsToForward", receivedAckPacketsToForward);
-    recordScalar("receivedAckPacketsToForwardCorrect",
+    LoRaScalarCollector::record(this, "receivedAckPacketsToForward", receivedAckPacketsToForward);
+    LoRaScalarCollector::record(this, "receivedAckPacketsToForwardCorrect",
             receivedAckPacketsToForwardCorrect);
-    recordScalar("receivedAckPacketsToForwardExpired",
+    LoRaScalarCollector::record(this, "receivedAckPacketsToForwardExpired",
             receivedAckPacketsToForwardExpired);
-    recordScalar("receivedAckPacketsToForwardUnique",
+    LoRaScalarCollector::record(this, "receivedAckPacketsToForwardUnique",
             receivedAckPacketsToForwardUnique);
-    recordScalar("receivedAckPackets", receivedAckPackets);
-    recordScalar("receivedAckPacketsForMe", receivedAckPacketsForMe);
-    recordScalar("receivedAckPacketsFromMe", receivedAckPacketsFromMe);
-    recordScalar("receivedADRCommands", receivedADRCommands);
-    recordScalar("forwardedPackets", forwardedPackets);
-    recordScalar("forwardedDataPackets", forwardedDataPackets);
-    recordScalar("forwardedAckPackets", forwardedAckPackets);
-    recordScalar("forwardPacketsDuplicateAvoid", forwardPacketsDuplicateAvoid);
-    recordScalar("packetsToForwardMaxVectorSize", packetsToForwardMaxVectorSize);
-    recordScalar("broadcastDataPackets", broadcastDataPackets);
-    recordScalar("broadcastForwardedPackets", broadcastForwardedPackets);
-
-    recordScalar("firstDataPacketTransmissionTime", firstDataPacketTransmissionTime);
-    recordScalar("lastDataPacketTransmissionTime", lastDataPacketTransmissionTime);
-    recordScalar("firstDataPacketReceptionTime", firstDataPacketReceptionTime);
-    recordScalar("lastDataPacketReceptionTime", lastDataPacketReceptionTime);
-
-    recordScalar("receivedADRCommands", receivedADRCommands);
-    recordScalar("AppACKReceived", AppACKReceived);
-    recordScalar("firstACK", firstACK);
-    recordScalar("firstACKSF", firstACKSF);
-
-    recordScalar("dataPacketsNotSent", LoRaPacketsToSend.size());
-    recordScalar("forwardPacketsNotSent", LoRaPacketsToSend.size());
-
-    recordScalar("forwardBufferFull", forwardBufferFull);
+    LoRaScalarCollector::record(this, "receivedAckPackets", receivedAckPackets);
+    LoRaScalarCollector::record(this, "receivedAckPacketsForMe", receivedAckPacketsForMe);
+    LoRaScalarCollector::record(this, "receivedAckPacketsFromMe", receivedAckPacketsFromMe);
+    LoRaScalarCollector::record(this, "receivedADRCommands", receivedADRCommands);
+    LoRaScalarCollector::record(this, "forwardedPackets", forwardedPackets);
+    LoRaScalarCollector::record(this, "forwardedDataPackets", forwardedDataPackets);
+    LoRaScalarCollector::record(this, "forwardedAckPackets", forwardedAckPackets);
+    LoRaScalarCollector::record(this, "forwardPacketsDuplicateAvoid", forwardPacketsDuplicateAvoid);
+    LoRaScalarCollector::record(this, "packetsToForwardMaxVectorSize", packetsToForwardMaxVectorSize);
+    LoRaScalarCollector::record(this, "broadcastDataPackets", broadcastDataPackets);
+    LoRaScalarCollector::record(this, "broadcastForwardedPackets", broadcastForwardedPackets);
+
+    LoRaScalarCollector::record(this, "firstDataPacketTransmissionTime", firstDataPacketTransmissionTime);
+    LoRaScalarCollector::record(this, "lastDataPacketTransmissionTime", lastDataPacketTransmissionTime);
+    LoRaScalarCollector::record(this, "firstDataPacketReceptionTime", firstDataPacketReceptionTime);
+    LoRaScalarCollector::record(this, "lastDataPacketReceptionTime", lastDataPacketReceptionTime);
+
+    LoRaScalarCollector::record(this, "receivedADRCommands", receivedADRCommands);
+    LoRaScalarCollector::record(this, "AppACKReceived", AppACKReceived);
+    LoRaScalarCollector::record(this, "firstACK", firstACK);
+    LoRaScalarCollector::record(this, "firstACKSF", firstACKSF);
+
+    LoRaScalarCollector::record(this, "dataPacketsNotSent", LoRaPacketsToSend.size());
+    LoRaScalarCollector::record(this, "forwardPacketsNotSent", LoRaPacketsToSend.size());
+
+    LoRaScalarCollector::record(this, "forwardBufferFull", forwardBufferFull);
 
     for (std::vector<LoRaAppPacket>::iterator lbptr = LoRaPacketsToSend.begin();
             lbptr < LoRaPacketsToSend.end(); lbptr++) {
@@ -557,40 +558,40 @@ void LoRaEndNodeApp::finish() {
         DataPacketsForMe.erase(lbptr);
     }
 
-    recordScalar("dataPacketsForMeLatencyMax", dataPacketsForMeLatency.getMax());
-    recordScalar("dataPacketsForMeLatencyMean", dataPacketsForMeLatency.getMean());
-    recordScalar("dataPacketsForMeLatencyMin", dataPacketsForMeLatency.getMin());
-    recordScalar("dataPacketsForMeLatencyStdv", dataPacketsForMeLatency.getStddev());
-
-    recordScalar("dataPacketsForMeUniqueLatencyMax", dataPacketsForMeUniqueLatency.getMax());
-    recordScalar("dataPacketsForMeUniqueLatencyMean", dataPacketsForMeUniqueLatency.getMean());
-    recordScalar("dataPacketsForMeUniqueLatencyMin", dataPacketsForMeUniqueLatency.getMin());
-    recordScalar("dataPacketsForMeUniqueLatencyStdv", dataPacketsForMeUniqueLatency.getStddev());
-
-    recordScalar("routingTableSizeMax", routingTableSize.getMax());
-    recordScalar("routingTableSizeMean", routingTableSize.getMean());
-    recordScalar("routingTableSizeMin", routingTableSize.getMin());
-    recordScalar("routingTableSizeStdv", routingTableSize.getStddev());
-
-    recordScalar("allTxPacketsSFStatsMax", allTxPacketsSFStats.getMax());
-    recordScalar("allTxPacketsSFStatsMean", allTxPacketsSFStats.getMean());
-    recordScalar("allTxPacketsSFStatsMin", allTxPacketsSFStats.getMin());
-    recordScalar("allTxPacketsSFStatsStdv", allTxPacketsSFStats.getStddev());
-    recordScalar("routingTxPacketsSFStatsMax", routingTxPacketsSFStats.getMax());
-    recordScalar("routingTxPacketsSFStatsMean", routingTxPacketsSFStats.getMean());
-    recordScalar("routingTxPacketsSFStatsMin", routingTxPacketsSFStats.getMin());
-    recordScalar("routingTxPacketsSFStatsStdv", routingTxPacketsSFStats.getStddev());
-    recordScalar("owndataTxPacketsSFStatsMax", routingTxPacketsSFStats.getMax());
-    recordScalar("owndataTxPacketsSFStatsMean", routingTxPacketsSFStats.getMean());
-    recordScalar("owndataTxPacketsSFStatsMin", routingTxPacketsSFStats.getMin());
-    recordScalar("owndataTxPacketsSFStatsStdv", routingTxPacketsSFStats.getStddev());
-    recordScalar("fwdTxPacketsSFStatsMax", routingTxPacketsSFStats.getMax());
-    recordScalar("fwdTxPacketsSFStatsMean", routingTxPacketsSFStats.getMean());
-    recordScalar("fwdTxPacketsSFStatsMin", routingTxPacketsSFStats.getMin());
-    recordScalar("fwdTxPacketsSFStatsStdv", routingTxPacketsSFStats.getStddev());
-
-    dataPacketsForMeLatency.recordAs("dataPacketsForMeLatency");
-    dataPacketsForMeUniqueLatency.recordAs("dataPacketsForMeUniqueLatency");
+    LoRaScalarCollector::record(this, "dataPacketsForMeLatencyMax", dataPacketsForMeLatency.getMax());
+    LoRaScalarCollector::record(this, "dataPacketsForMeLatencyMean", dataPacketsForMeLatency.getMean());
+    LoRaScalarCollector::record(this, "dataPacketsForMeLatencyMin", dataPacketsForMeLatency.getMin());
+    LoRaScalarCollector::record(this, "dataPacketsForMeLatencyStdv", dataPacketsForMeLatency.getStddev());
+
+    LoRaScalarCollector::record(this, "dataPacketsForMeUniqueLatencyMax", dataPacketsForMeUniqueLatency.getMax());
+    LoRaScalarCollector::record(this, "dataPacketsForMeUniqueLatencyMean", dataPacketsForMeUniqueLatency.getMean());
+    LoRaScalarCollector::record(this, "dataPacketsForMeUniqueLatencyMin", dataPacketsForMeUniqueLatency.getMin());
+    LoRaScalarCollector::record(this, "dataPacketsForMeUniqueLatencyStdv", dataPacketsForMeUniqueLatency.getStddev());
+
+    LoRaScalarCollector::record(this, "routingTableSizeMax", routingTableSize.getMax());
+    LoRaScalarCollector::record(this, "routingTableSizeMean", routingTableSize.getMean());
+    LoRaScalarCollector::record(this, "routingTableSizeMin", routingTableSize.getMin());
+    LoRaScalarCollector::record(this, "routingTableSizeStdv", routingTableSize.getStddev());
+
+    LoRaScalarCollector::record(this, "allTxPacketsSFStatsMax", allTxPacketsSFStats.getMax());
+    LoRaScalarCollector::record(this, "allTxPacketsSFStatsMean", allTxPacketsSFStats.getMean());
+    LoRaScalarCollector::record(this, "allTxPacketsSFStatsMin", allTxPacketsSFStats.getMin());
+    LoRaScalarCollector::record(this, "allTxPacketsSFStatsStdv", allTxPacketsSFStats.getStddev());
+    LoRaScalarCollector::record(this, "routingTxPacketsSFStatsMax", routingTxPacketsSFStats.getMax());
+    LoRaScalarCollector::record(this, "routingTxPacketsSFStatsMean", routingTxPacketsSFStats.getMean());
+    LoRaScalarCollector::record(this, "routingTxPacketsSFStatsMin", routingTxPacketsSFStats.getMin());
+    LoRaScalarCollector::record(this, "routingTxPacketsSFStatsStdv", routingTxPacketsSFStats.getStddev());
+    LoRaScalarCollector::record(this, "owndataTxPacketsSFStatsMax", routingTxPacketsSFStats.getMax());
+    LoRaScalarCollector::record(this, "owndataTxPacketsSFStatsMean", routingTxPacketsSFStats.getMean());
+    LoRaScalarCollector::record(this, "owndataTxPacketsSFStatsMin", routingTxPacketsSFStats.getMin());
+    LoRaScalarCollector::record(this, "owndataTxPacketsSFStatsStdv", routingTxPacketsSFStats.getStddev());
+    LoRaScalarCollector::record(this, "fwdTxPacketsSFStatsMax", routingTxPacketsSFStats.getMax());
+    LoRaScalarCollector::record(this, "fwdTxPacketsSFStatsMean", routingTxPacketsSFStats.getMean());
+    LoRaScalarCollector::record(this, "fwdTxPacketsSFStatsMin", routingTxPacketsSFStats.getMin());
+    LoRaScalarCollector::record(this, "fwdTxPacketsSFStatsStdv", routingTxPacketsSFStats.getStddev());
+
+    LoRaScalarCollector::record(this, "dataPacketsForMeLatency", dataPacketsForMeLatency);
+    LoRaScalarCollector::record(this, "dataPacketsForMeUniqueLatency", dataPacketsForMeUniqueLatency);
 }
 
 void LoRaEndNodeApp::handleMessage(cMessage *msg) {
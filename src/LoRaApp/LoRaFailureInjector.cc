@@ -0,0 +1,355 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include "LoRaFailureInjector.h"
+#include "misc/LoRaScalarCollector.h"
+#include "LoRaNodeApp.h"
+#include "LoRaNodeOperations.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <string>
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+#include "inet/common/lifecycle/NodeOperations.h"
+#include "inet/mobility/static/StationaryMobility.h"
+
+namespace inet {
+
+Define_Module(LoRaFailureInjector);
+
+namespace {
+
+// Heap order: earliest restart first
+struct RestartsLater {
+    template<typename T>
+    bool operator()(const T& a, const T& b) const { return a.time > b.time; }
+};
+
+double getRequiredAttribute(cXMLElement *element, const char *name)
+{
+    const char *value = element->getAttribute(name);
+    if (value == nullptr)
+        throw cRuntimeError("<%s> at %s needs attribute '%s'", element->getTagName(), element->getSourceLocation(), name);
+    return atof(value);
+}
+
+}
+
+LoRaFailureInjector::~LoRaFailureInjector()
+{
+    cancelAndDelete(outageTimer);
+    cancelAndDelete(restartTimer);
+}
+
+void LoRaFailureInjector::initialize()
+{
+    gridCellSize = par("gridCellSize");
+    if (!(gridCellSize > 0))
+        throw cRuntimeError("gridCellSize must be positive");
+    outageTimer = new cMessage("outageTimer");
+    restartTimer = new cMessage("restartTimer");
+
+    readSchedule(par("schedule").xmlValue());
+    generateOutages();
+    std::stable_sort(outages.begin(), outages.end(), [](const Outage& a, const Outage& b) { return a.time < b.time; });
+    if (!outages.empty())
+        scheduleAt(std::max(simTime(), outages.front().time), outageTimer);
+
+    WATCH(nextOutage);
+    WATCH(nodesCrashed);
+    WATCH(nodesRestarted);
+}
+
+void LoRaFailureInjector::handleMessage(cMessage *msg)
+{
+    if (msg == outageTimer) {
+        while (nextOutage < outages.size() && outages[nextOutage].time <= simTime())
+            startOutage(nextOutage++);
+        if (nextOutage < outages.size())
+            scheduleAt(outages[nextOutage].time, outageTimer);
+        scheduleNextRestart();
+    }
+    else if (msg == restartTimer) {
+        restartDueNodes();
+        scheduleNextRestart();
+    }
+    else
+        throw cRuntimeError("Unexpected message %s", msg->getName());
+}
+
+void LoRaFailureInjector::finish()
+{
+    LoRaScalarCollector::record(this, "outages", outagesStarted);
+    LoRaScalarCollector::record(this, "nodesCrashed", nodesCrashed);
+    LoRaScalarCollector::record(this, "nodesRestarted", nodesRestarted);
+    writeTimeline();
+}
+
+void LoRaFailureInjector::readSchedule(cXMLElement *schedule)
+{
+    // <failures>
+    //   <region t="600" x="500" y="800" radius="300" duration="1200" stagger="300"/>
+    //   <line t="900" x1="0" y1="0" x2="2000" y2="500" width="200" duration="-1"/>
+    // </failures>
+    // Times in seconds, distances in metres; duration and stagger default to
+    // the outageDuration and recoveryStagger parameters
+    if (schedule == nullptr)
+        return;
+    for (cXMLElement *element : schedule->getChildren()) {
+        Outage outage;
+        outage.time = getRequiredAttribute(element, "t");
+        outage.generated = false;
+        if (strcmp(element->getTagName(), "region") == 0) {
+            outage.shape = OUTAGE_CIRCLE;
+            outage.a = Coord(getRequiredAttribute(element, "x"), getRequiredAttribute(element, "y"), 0);
+            outage.radius = getRequiredAttribute(element, "radius");
+        }
+        else if (strcmp(element->getTagName(), "line") == 0) {
+            outage.shape = OUTAGE_LINE;
+            outage.a = Coord(getRequiredAttribute(element, "x1"), getRequiredAttribute(element, "y1"), 0);
+            outage.b = Coord(getRequiredAttribute(element, "x2"), getRequiredAttribute(element, "y2"), 0);
+            outage.radius = getRequiredAttribute(element, "width") / 2;
+        }
+        else
+            throw cRuntimeError("Unknown outage <%s> at %s (region or line)", element->getTagName(), element->getSourceLocation());
+        const char *duration = element->getAttribute("duration");
+        outage.duration = duration != nullptr ? simtime_t(atof(duration)) : simtime_t(par("outageDuration").doubleValue());
+        const char *stagger = element->getAttribute("stagger");
+        outage.stagger = stagger != nullptr ? simtime_t(atof(stagger)) : simtime_t(par("recoveryStagger").doubleValue());
+        outages.push_back(outage);
+    }
+}
+
+void LoRaFailureInjector::generateOutages()
+{
+    int count = par("generatedOutages");
+    if (count <= 0)
+        return;
+    const char *shape = par("generatedShape").stringValue();
+    OutageShape outageShape;
+    if (strcmp(shape, "circle") == 0)
+        outageShape = OUTAGE_CIRCLE;
+    else if (strcmp(shape, "line") == 0)
+        outageShape = OUTAGE_LINE;
+    else
+        throw cRuntimeError("Unknown generatedShape '%s' (circle or line)", shape);
+    simtime_t time = par("generatedStartTime");
+    double meanInterval = par("generatedMeanInterval");
+    for (int i = 0; i < count; i++) {
+        if (meanInterval > 0)
+            time += exponential(meanInterval);
+        Outage outage;
+        outage.time = time;
+        outage.shape = outageShape;
+        outage.radius = outageShape == OUTAGE_CIRCLE ? par("generatedRadius").doubleValue() : par("generatedLineWidth").doubleValue() / 2;
+        outage.duration = par("outageDuration").doubleValue();
+        outage.stagger = par("recoveryStagger").doubleValue();
+        outage.generated = true;
+        outages.push_back(outage);
+    }
+}
+
+void LoRaFailureInjector::buildIndex()
+{
+    // Node positions are only final after initialization, so the index is
+    // built when the first outage starts
+    cModule *network = getParentModule();
+    std::set<std::string> targetNames;
+    cStringTokenizer tokenizer(par("targetModules").stringValue());
+    while (tokenizer.hasMoreTokens())
+        targetNames.insert(tokenizer.nextToken());
+    for (cModule::SubmoduleIterator it(network); !it.end(); ++it) {
+        cModule *host = *it;
+        if (targetNames.count(host->getName()) == 0)
+            continue;
+        Target target;
+        target.host = host;
+        target.app = dynamic_cast<LoRaNodeApp *>(host->getSubmodule("LoRaNodeApp"));
+        target.mobility = dynamic_cast<IMobility *>(host->getSubmodule("mobility"));
+        if (target.mobility == nullptr)
+            throw cRuntimeError("Target node %s has no mobility submodule", host->getFullPath().c_str());
+        target.position = target.mobility->getCurrentPosition();
+        target.position.z = 0;
+        targets.push_back(target);
+    }
+
+    for (int i = 0; i < (int)targets.size(); i++) {
+        const Coord& position = targets[i].position;
+        if (i == 0)
+            areaMin = areaMax = position;
+        areaMin.x = std::min(areaMin.x, position.x);
+        areaMin.y = std::min(areaMin.y, position.y);
+        areaMax.x = std::max(areaMax.x, position.x);
+        areaMax.y = std::max(areaMax.y, position.y);
+        if (dynamic_cast<StationaryMobility *>(targets[i].mobility) == nullptr) {
+            mobileTargets.push_back(i);
+            continue;
+        }
+        int x = getCell(position.x);
+        int y = getCell(position.y);
+        if (grid.empty()) {
+            minCellX = maxCellX = x;
+            minCellY = maxCellY = y;
+        }
+        minCellX = std::min(minCellX, x);
+        maxCellX = std::max(maxCellX, x);
+        minCellY = std::min(minCellY, y);
+        maxCellY = std::max(maxCellY, y);
+        grid[getCellKey(x, y)].push_back(i);
+    }
+    indexed = true;
+    EV_INFO << "Indexed " << targets.size() << " target nodes (" << mobileTargets.size() << " mobile) in "
+            << grid.size() << " grid cells" << endl;
+}
+
+bool LoRaFailureInjector::isInside(const Outage& outage, const Coord& position) const
+{
+    if (outage.shape == OUTAGE_CIRCLE)
+        return position.sqrdist(outage.a) <= outage.radius * outage.radius;
+    // Distance to the line segment
+    Coord segment = outage.b - outage.a;
+    double length2 = segment.x * segment.x + segment.y * segment.y;
+    double t = length2 > 0 ? ((position.x - outage.a.x) * segment.x + (position.y - outage.a.y) * segment.y) / length2 : 0;
+    t = std::max(0.0, std::min(1.0, t));
+    Coord closest = outage.a + segment * t;
+    return position.sqrdist(closest) <= outage.radius * outage.radius;
+}
+
+void LoRaFailureInjector::findVictims(const Outage& outage, std::vector<int>& victims) const
+{
+    double minX = std::min(outage.a.x, outage.shape == OUTAGE_LINE ? outage.b.x : outage.a.x) - outage.radius;
+    double maxX = std::max(outage.a.x, outage.shape == OUTAGE_LINE ? outage.b.x : outage.a.x) + outage.radius;
+    double minY = std::min(outage.a.y, outage.shape == OUTAGE_LINE ? outage.b.y : outage.a.y) - outage.radius;
+    double maxY = std::max(outage.a.y, outage.shape == OUTAGE_LINE ? outage.b.y : outage.a.y) + outage.radius;
+    // Only the cells overlapping both the outage and the populated area are visited
+    int fromX = std::max(minCellX, getCell(minX));
+    int toX = std::min(maxCellX, getCell(maxX));
+    int fromY = std::max(minCellY, getCell(minY));
+    int toY = std::min(maxCellY, getCell(maxY));
+    for (int x = fromX; x <= toX; x++) {
+        for (int y = fromY; y <= toY; y++) {
+            auto it = grid.find(getCellKey(x, y));
+            if (it == grid.end())
+                continue;
+            for (int index : it->second)
+                if (isInside(outage, targets[index].position))
+                    victims.push_back(index);
+        }
+    }
+    for (int index : mobileTargets) {
+        Coord position = targets[index].mobility->getCurrentPosition();
+        position.z = 0;
+        if (isInside(outage, position))
+            victims.push_back(index);
+    }
+}
+
+void LoRaFailureInjector::startOutage(int outageIndex)
+{
+    if (!indexed)
+        buildIndex();
+    Outage& outage = outages[outageIndex];
+    if (outage.generated) {
+        outage.a = Coord(uniform(areaMin.x, areaMax.x), uniform(areaMin.y, areaMax.y), 0);
+        if (outage.shape == OUTAGE_LINE) {
+            double angle = uniform(0, M_PI);
+            double halfLength = par("generatedLineLength").doubleValue() / 2;
+            Coord direction(cos(angle) * halfLength, sin(angle) * halfLength, 0);
+            outage.b = outage.a + direction;
+            outage.a = outage.a - direction;
+        }
+    }
+    outagesStarted++;
+
+    std::vector<int> victims;
+    findVictims(outage, victims);
+    int crashed = 0;
+    for (int index : victims) {
+        Target& target = targets[index];
+        if (target.outages == 0) {
+            // Nodes already down for their own reasons are left alone
+            if (target.app != nullptr && target.app->isFailed())
+                continue;
+            applyNodeOperation(target.host, new NodeCrashOperation());
+            timeline.push_back({ simTime(), outageIndex, true, target.app ? target.app->getNodeId() : target.host->getIndex() });
+            nodesCrashed++;
+            crashed++;
+        }
+        target.outages++;
+        if (outage.duration >= SIMTIME_ZERO) {
+            simtime_t restartTime = simTime() + outage.duration;
+            if (outage.stagger > SIMTIME_ZERO)
+                restartTime += uniform(0, outage.stagger.dbl());
+            restarts.push_back({ restartTime, index, outageIndex });
+            std::push_heap(restarts.begin(), restarts.end(), RestartsLater());
+        }
+    }
+    EV_WARN << "[Outage] " << outageIndex << (outage.shape == OUTAGE_CIRCLE ? " circle at (" : " line from (")
+            << outage.a.x << ", " << outage.a.y << ")";
+    if (outage.shape == OUTAGE_LINE)
+        EV_WARN << " to (" << outage.b.x << ", " << outage.b.y << ")";
+    EV_WARN << ": " << victims.size() << " nodes affected, " << crashed << " crashed" << endl;
+}
+
+void LoRaFailureInjector::restartDueNodes()
+{
+    while (!restarts.empty() && restarts.front().time <= simTime()) {
+        std::pop_heap(restarts.begin(), restarts.end(), RestartsLater());
+        Restart restart = restarts.back();
+        restarts.pop_back();
+        Target& target = targets[restart.target];
+        // A node hit by overlapping outages restarts after the last of them
+        if (--target.outages > 0)
+            continue;
+        applyNodeOperation(target.host, new NodeStartOperation());
+        timeline.push_back({ simTime(), restart.outage, false, target.app ? target.app->getNodeId() : target.host->getIndex() });
+        nodesRestarted++;
+    }
+}
+
+void LoRaFailureInjector::scheduleNextRestart()
+{
+    cancelEvent(restartTimer);
+    if (!restarts.empty())
+        scheduleAt(restarts.front().time, restartTimer);
+}
+
+void LoRaFailureInjector::writeTimeline() const
+{
+#ifdef _WIN32
+    _mkdir("delivered_packets");
+#else
+    mkdir("delivered_packets", 0775);
+#endif
+    std::ofstream file("delivered_packets/failure_timeline.csv", std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+        EV_WARN << "Cannot write delivered_packets/failure_timeline.csv" << endl;
+        return;
+    }
+    file << "simTime,outage,event,nodeId\n";
+    for (const auto& entry : timeline)
+        file << entry.time << ',' << entry.outage << ',' << (entry.crash ? "crash" : "restart") << ',' << entry.nodeId << '\n';
+}
+
+}
@@ -0,0 +1,123 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#ifndef __LORA_OMNET_LORAFAILUREINJECTOR_H_
+#define __LORA_OMNET_LORAFAILUREINJECTOR_H_
+
+#include <omnetpp.h>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "inet/common/geometry/common/Coord.h"
+#include "inet/mobility/contract/IMobility.h"
+
+using namespace omnetpp;
+
+namespace inet {
+
+class LoRaNodeApp;
+
+/**
+ * Injects spatially correlated outages: every node within a circle around an
+ * epicentre, or within a corridor along a line, crashes at the same time and
+ * restarts after the outage duration plus a per-node stagger. Outages come
+ * from the schedule XML and/or are generated at random over the area of the
+ * target nodes. Crash and restart are NodeCrashOperation/NodeStartOperation
+ * applied to the whole node, so radio, MAC and application go down together.
+ *
+ * Victims are found through a uniform grid over the stationary nodes; mobile
+ * nodes are checked individually. All crashes and restarts are written to
+ * delivered_packets/failure_timeline.csv at the end of the run.
+ */
+class INET_API LoRaFailureInjector : public cSimpleModule
+{
+    protected:
+        enum OutageShape {
+            OUTAGE_CIRCLE,
+            OUTAGE_LINE
+        };
+        struct Outage {
+            simtime_t time;
+            OutageShape shape;
+            Coord a;              // epicentre, or line start
+            Coord b;              // line end
+            double radius;        // circle radius, or half the corridor width
+            simtime_t duration;   // negative: the victims do not recover
+            simtime_t stagger;    // restarts spread uniformly over [0, stagger]
+            bool generated;       // geometry is drawn when the outage starts
+        };
+        struct Target {
+            cModule *host;
+            LoRaNodeApp *app;
+            IMobility *mobility;
+            Coord position;       // of stationary nodes, taken when the index is built
+            int outages = 0;      // outages currently holding the node down
+        };
+        struct Restart {
+            simtime_t time;
+            int target;
+            int outage;
+        };
+        struct TimelineEntry {
+            simtime_t time;
+            int outage;
+            bool crash;
+            int nodeId;
+        };
+
+        std::vector<Outage> outages;  // sorted by time
+        size_t nextOutage = 0;
+        std::vector<Restart> restarts;  // min-heap on time
+        cMessage *outageTimer = nullptr;
+        cMessage *restartTimer = nullptr;
+
+        std::vector<Target> targets;
+        std::vector<int> mobileTargets;
+        std::unordered_map<int64_t, std::vector<int>> grid;
+        double gridCellSize = 0;
+        int minCellX = 0, minCellY = 0, maxCellX = -1, maxCellY = -1;
+        Coord areaMin, areaMax;  // bounding box of all targets
+        bool indexed = false;
+        long outagesStarted = 0;
+
+        std::vector<TimelineEntry> timeline;
+        long nodesCrashed = 0;
+        long nodesRestarted = 0;
+
+    protected:
+        virtual void initialize() override;
+        virtual void handleMessage(cMessage *msg) override;
+        virtual void finish() override;
+
+        void readSchedule(cXMLElement *schedule);
+        void generateOutages();
+        void buildIndex();
+        int64_t getCellKey(int x, int y) const { return ((int64_t)x << 32) ^ (uint32_t)y; }
+        int getCell(double coordinate) const { return (int)floor(coordinate / gridCellSize); }
+        bool isInside(const Outage& outage, const Coord& position) const;
+        void findVictims(const Outage& outage, std::vector<int>& victims) const;
+        void startOutage(int outageIndex);
+        void restartDueNodes();
+        void scheduleNextRestart();
+        void writeTimeline() const;
+
+    public:
+        virtual ~LoRaFailureInjector();
+};
+
+}
+
+#endif
@@ -0,0 +1,156 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include "LoRaFlowStatistics.h"
+#include "misc/LoRaScalarCollector.h"
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+namespace inet {
+
+Define_Module(LoRaFlowStatistics);
+
+void LoRaFlowStatistics::initialize()
+{
+    latency.setResolution(par("latencyResolution").doubleValue());
+    hops.setResolution(1);
+
+    WATCH(generated);
+    WATCH(delivered);
+    WATCH(duplicates);
+    WATCH(forwarded);
+}
+
+void LoRaFlowStatistics::handleMessage(cMessage *msg)
+{
+    throw cRuntimeError("LoRaFlowStatistics does not process messages");
+}
+
+void LoRaFlowStatistics::reportGenerated(int source, int destination)
+{
+    Enter_Method_Silent();
+    flows[getFlowKey(source, destination)].generated++;
+    nodes[source].generated++;
+    generated++;
+}
+
+void LoRaFlowStatistics::reportForwarded(int node)
+{
+    Enter_Method_Silent();
+    nodes[node].forwarded++;
+    forwarded++;
+}
+
+void LoRaFlowStatistics::reportDelivered(int source, int destination, int sequence, simtime_t packetLatency, int hopCount)
+{
+    Enter_Method_Silent();
+    Flow& flow = flows[getFlowKey(source, destination)];
+    Node& node = nodes[destination];
+    if (!flow.deliveredSequences.insert(sequence).second) {
+        flow.duplicates++;
+        node.duplicates++;
+        duplicates++;
+        return;
+    }
+    double seconds = packetLatency.dbl();
+    flow.latencyMin = flow.delivered == 0 ? seconds : std::min(flow.latencyMin, seconds);
+    flow.latencyMax = flow.delivered == 0 ? seconds : std::max(flow.latencyMax, seconds);
+    flow.latencySum += seconds;
+    if (hopCount >= 0) {
+        flow.hopSamples++;
+        flow.hopSum += hopCount;
+        flow.hopMax = std::max(flow.hopMax, hopCount);
+        hops.collect(hopCount);
+    }
+    if (flow.firstDelivery < 0)
+        flow.firstDelivery = simTime();
+    flow.lastDelivery = simTime();
+    flow.delivered++;
+    node.delivered++;
+    delivered++;
+    latency.collect(seconds);
+}
+
+void LoRaFlowStatistics::finish()
+{
+    LoRaScalarCollector::record(this, "flows", flows.size());
+    LoRaScalarCollector::record(this, "packetsGenerated", generated);
+    LoRaScalarCollector::record(this, "packetsDelivered", delivered);
+    LoRaScalarCollector::record(this, "duplicateDeliveries", duplicates);
+    LoRaScalarCollector::record(this, "forwardTransmissions", forwarded);
+    LoRaScalarCollector::record(this, "deliveryRatio", generated > 0 ? (double)delivered / generated : 0);
+    latency.recordScalars(this, "latency", "s");
+    hops.recordScalars(this, "hopCount");
+    if (par("writeSummaries"))
+        writeSummaries();
+}
+
+void LoRaFlowStatistics::writeSummaries() const
+{
+#ifdef _WIN32
+    _mkdir("delivered_packets");
+#else
+    mkdir("delivered_packets", 0775);
+#endif
+    // Sorted output, so that runs can be diffed
+    std::vector<uint64_t> flowKeys;
+    flowKeys.reserve(flows.size());
+    for (const auto& flow : flows)
+        flowKeys.push_back(flow.first);
+    std::sort(flowKeys.begin(), flowKeys.end());
+    std::ofstream flowFile("delivered_packets/flow_summary.csv", std::ios::out | std::ios::trunc);
+    if (flowFile.is_open()) {
+        flowFile << "src,dst,generated,delivered,duplicates,deliveryRatio,meanLatency,minLatency,maxLatency,meanHopCount,maxHopCount,firstDelivery,lastDelivery\n";
+        for (uint64_t key : flowKeys) {
+            const Flow& flow = flows.at(key);
+            flowFile << (int)(key >> 32) << ',' << (int)(uint32_t)key << ','
+                     << flow.generated << ',' << flow.delivered << ',' << flow.duplicates << ','
+                     << (flow.generated > 0 ? (double)flow.delivered / flow.generated : 0) << ',';
+            if (flow.delivered > 0)
+                flowFile << flow.latencySum / flow.delivered << ',' << flow.latencyMin << ',' << flow.latencyMax << ','
+                         << (flow.hopSamples > 0 ? std::to_string((double)flow.hopSum / flow.hopSamples) : "") << ','
+                         << (flow.hopSamples > 0 ? std::to_string(flow.hopMax) : "") << ','
+                         << flow.firstDelivery << ',' << flow.lastDelivery << '\n';
+            else
+                flowFile << ",,,,,,\n";
+        }
+    }
+    else
+        EV_WARN << "Cannot write delivered_packets/flow_summary.csv" << endl;
+
+    std::map<int, const Node *> sortedNodes;
+    for (const auto& node : nodes)
+        sortedNodes[node.first] = &node.second;
+    std::ofstream nodeFile("delivered_packets/node_summary.csv", std::ios::out | std::ios::trunc);
+    if (nodeFile.is_open()) {
+        nodeFile << "nodeId,generated,forwarded,delivered,duplicates\n";
+        for (const auto& node : sortedNodes)
+            nodeFile << node.first << ',' << node.second->generated << ',' << node.second->forwarded << ','
+                     << node.second->delivered << ',' << node.second->duplicates << '\n';
+    }
+    else
+        EV_WARN << "Cannot write delivered_packets/node_summary.csv" << endl;
+}
+
+}
@@ -0,0 +1,90 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#ifndef __LORA_OMNET_LORAFLOWSTATISTICS_H_
+#define __LORA_OMNET_LORAFLOWSTATISTICS_H_
+
+#include <omnetpp.h>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "misc/LoRaStreamingStatistic.h"
+
+using namespace omnetpp;
+
+namespace inet {
+
+/**
+ * Delivery ratio, end-to-end latency, hop count and duplicates of every
+ * (source, destination) flow, kept online from the reports of the nodes so
+ * that no per-hop trace has to be written and analyzed afterwards. Every
+ * report is a constant-time update of a hash map entry; the sequence numbers
+ * already delivered are kept per flow to tell duplicates apart.
+ */
+class INET_API LoRaFlowStatistics : public cSimpleModule
+{
+    protected:
+        struct Flow {
+            long generated = 0;
+            long delivered = 0;     // unique packets
+            long duplicates = 0;
+            double latencySum = 0;
+            double latencyMin = 0;
+            double latencyMax = 0;
+            long hopSamples = 0;
+            long hopSum = 0;
+            int hopMax = 0;
+            simtime_t firstDelivery = -1;
+            simtime_t lastDelivery = -1;
+            std::unordered_set<int> deliveredSequences;
+        };
+        struct Node {
+            long generated = 0;
+            long forwarded = 0;     // forwarding transmissions
+            long delivered = 0;     // unique packets received as destination
+            long duplicates = 0;
+        };
+
+        std::unordered_map<uint64_t, Flow> flows;
+        std::unordered_map<int, Node> nodes;
+        LoRaStreamingStatistic latency;
+        LoRaStreamingStatistic hops;
+        long generated = 0;
+        long delivered = 0;
+        long duplicates = 0;
+        long forwarded = 0;
+
+    protected:
+        virtual void initialize() override;
+        virtual void handleMessage(cMessage *msg) override;
+        virtual void finish() override;
+
+        static uint64_t getFlowKey(int source, int destination) { return ((uint64_t)(uint32_t)source << 32) | (uint32_t)destination; }
+        void writeSummaries() const;
+
+    public:
+        /** A node sent a data packet of its own. */
+        void reportGenerated(int source, int destination);
+        /** A node transmitted a data packet for another node. */
+        void reportForwarded(int node);
+        /** The destination received a data packet; hopCount is negative when unknown. */
+        void reportDelivered(int source, int destination, int sequence, simtime_t latency, int hopCount);
+};
+
+}
+
+#endif
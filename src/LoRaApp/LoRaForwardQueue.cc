@@ -0,0 +1,169 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include "LoRaForwardQueue.h"
+
+namespace inet {
+
+namespace {
+
+bool isSamePacket(const LoRaAppPacket& a, const LoRaAppPacket& b)
+{
+    return a.getMsgType() == b.getMsgType() && a.getDataInt() == b.getDataInt()
+            && a.getSource() == b.getSource() && a.getDestination() == b.getDestination();
+}
+
+}
+
+void LoRaForwardQueue::setScheduling(bool perFlow, long quantum)
+{
+    if (quantum <= 0)
+        throw cRuntimeError("Forwarding quantum must be positive");
+    if (count > 0)
+        throw cRuntimeError("Cannot change the forwarding scheduler of a non-empty queue");
+    this->perFlow = perFlow;
+    this->quantum = quantum;
+}
+
+int64_t LoRaForwardQueue::getFlowKey(const LoRaAppPacket& packet) const
+{
+    if (!perFlow)
+        return 0;
+    return ((int64_t)packet.getSource() << 32) ^ (uint32_t)packet.getDestination();
+}
+
+void LoRaForwardQueue::push_back(const LoRaAppPacket& packet)
+{
+    Flow& flow = flows[getFlowKey(packet)];
+    if (flow.packets.empty())
+        flow.ringPosition = ring.insert(ring.end(), getFlowKey(packet));
+    flow.packets.push_back(packet);
+    count++;
+}
+
+LoRaForwardQueue::Flow& LoRaForwardQueue::select()
+{
+    if (count == 0)
+        throw cRuntimeError("front() of an empty forwarding queue");
+    if (selected != nullptr)
+        return *selected;
+    // Visit the backlogged flows in turn, granting each a quantum per visit, until
+    // one has enough deficit for its head packet; ends within one or two rounds
+    while (true) {
+        Flow& flow = flows[ring.front()];
+        if (!flow.inTurn) {
+            flow.deficit += quantum;
+            flow.inTurn = true;
+        }
+        if (flow.packets.front().getByteLength() <= flow.deficit) {
+            selected = &flow;
+            return flow;
+        }
+        endTurn(flow, true);
+    }
+}
+
+void LoRaForwardQueue::endTurn(Flow& flow, bool backlogged)
+{
+    flow.inTurn = false;
+    if (backlogged)
+        ring.splice(ring.end(), ring, flow.ringPosition);
+    else {
+        ring.erase(flow.ringPosition);
+        flow.deficit = 0;  // an idle flow does not bank credit
+    }
+}
+
+void LoRaForwardQueue::pop_front()
+{
+    Flow& flow = select();
+    flow.deficit -= flow.packets.front().getByteLength();
+    flow.packets.pop_front();
+    count--;
+    selected = nullptr;
+    if (flow.packets.empty())
+        endTurn(flow, false);
+    else if (flow.packets.front().getByteLength() > flow.deficit)
+        endTurn(flow, true);
+}
+
+const LoRaAppPacket *LoRaForwardQueue::find(const LoRaAppPacket& packet) const
+{
+    auto it = flows.find(getFlowKey(packet));
+    if (it == flows.end())
+        return nullptr;
+    for (const auto& queued : it->second.packets)
+        if (isSamePacket(queued, packet))
+            return &queued;
+    return nullptr;
+}
+
+bool LoRaForwardQueue::erase(const LoRaAppPacket& packet)
+{
+    auto it = flows.find(getFlowKey(packet));
+    if (it == flows.end())
+        return false;
+    Flow& flow = it->second;
+    for (auto queued = flow.packets.begin(); queued != flow.packets.end(); queued++) {
+        if (isSamePacket(*queued, packet)) {
+            flow.packets.erase(queued);
+            count--;
+            selected = nullptr;
+            if (flow.packets.empty())
+                endTurn(flow, false);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<LoRaAppPacket> LoRaForwardQueue::extract(const std::function<bool(const LoRaAppPacket&)>& accept)
+{
+    std::vector<LoRaAppPacket> extracted;
+    std::vector<int64_t> order(ring.begin(), ring.end());  // endTurn() reorders the ring
+    for (int64_t key : order) {
+        Flow& flow = flows[key];
+        for (auto queued = flow.packets.begin(); queued != flow.packets.end(); ) {
+            if (accept(*queued)) {
+                flow.deficit -= queued->getByteLength();
+                extracted.push_back(*queued);
+                queued = flow.packets.erase(queued);
+                count--;
+            }
+            else
+                queued++;
+        }
+        if (flow.packets.empty())
+            endTurn(flow, false);
+    }
+    if (!extracted.empty())
+        selected = nullptr;
+    return extracted;
+}
+
+void LoRaForwardQueue::clear()
+{
+    flows.clear();
+    ring.clear();
+    selected = nullptr;
+    count = 0;
+}
+
+std::ostream& operator<<(std::ostream& os, const LoRaForwardQueue& queue)
+{
+    return os << queue.size() << " packets in " << queue.getNumBackloggedFlows() << " flows";
+}
+
+}
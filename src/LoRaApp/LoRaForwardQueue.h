@@ -0,0 +1,96 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#ifndef __LORA_OMNET_LORAFORWARDQUEUE_H_
+#define __LORA_OMNET_LORAFORWARDQUEUE_H_
+
+#include <omnetpp.h>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+#include "LoRaAppPacket_m.h"
+
+using namespace omnetpp;
+
+namespace inet {
+
+/**
+ * Packets waiting to be forwarded, one FIFO per flow (source, destination),
+ * served by deficit round robin: each backlogged flow may send up to
+ * `quantum` bytes per round, so a heavy flow cannot starve the others.
+ * With perFlow disabled every packet shares one flow, i.e. plain FIFO.
+ *
+ * front() is the packet the scheduler picks next; it stays the same until
+ * pop_front() or erase() is called. push_back() and pop_front() are O(1)
+ * (amortized, one hash lookup).
+ */
+class LoRaForwardQueue
+{
+    protected:
+        struct Flow {
+            std::deque<LoRaAppPacket> packets;
+            long deficit = 0;                          // bytes
+            bool inTurn = false;                       // quantum already granted for the current visit
+            std::list<int64_t>::iterator ringPosition; // valid while backlogged
+        };
+
+        bool perFlow = false;
+        long quantum = 64;
+        std::unordered_map<int64_t, Flow> flows;
+        std::list<int64_t> ring;    // backlogged flows in round robin order, the one being served first
+        Flow *selected = nullptr;   // flow whose head is front(), until it is sent
+        size_t count = 0;
+
+        int64_t getFlowKey(const LoRaAppPacket& packet) const;
+        Flow& select();
+        void endTurn(Flow& flow, bool backlogged);
+
+    public:
+        void setScheduling(bool perFlow, long quantum);
+
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        size_t getNumBackloggedFlows() const { return ring.size(); }
+
+        void push_back(const LoRaAppPacket& packet);
+        const LoRaAppPacket& front() { return select().packets.front(); }
+        void pop_front();
+
+        /**
+         * Packet with the same type, sequence number, source and destination
+         * as the given one, or nullptr. Only the packet's own flow is scanned.
+         */
+        const LoRaAppPacket *find(const LoRaAppPacket& packet) const;
+        bool erase(const LoRaAppPacket& packet);
+        void clear();
+
+        /**
+         * Removes and returns the queued packets the predicate accepts, visiting the
+         * flows in round robin order and each flow oldest first. The packets are
+         * charged to their flows' deficits as if they had been sent on their own.
+         */
+        std::vector<LoRaAppPacket> extract(const std::function<bool(const LoRaAppPacket&)>& accept);
+};
+
+std::ostream& operator<<(std::ostream& os, const LoRaForwardQueue& queue);
+
+}
+
+#endif
@@ -0,0 +1,100 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include "LoRaGeoNeighbourTable.h"
+
+#include <cmath>
+
+namespace inet {
+
+namespace {
+
+double getPlanarDistance2(const Coord& a, const Coord& b)
+{
+    return (a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y);
+}
+
+}
+
+void LoRaGeoNeighbourTable::update(int id, const Coord& position, simtime_t now)
+{
+    Neighbour& neighbour = neighbours[id];
+    neighbour.position = position;
+    neighbour.lastHeard = now;
+}
+
+void LoRaGeoNeighbourTable::purge(simtime_t now, simtime_t timeout)
+{
+    for (auto it = neighbours.begin(); it != neighbours.end(); ) {
+        if (now - it->second.lastHeard > timeout)
+            it = neighbours.erase(it);
+        else
+            it++;
+    }
+}
+
+int LoRaGeoNeighbourTable::findGreedyNextHop(const Coord& self, const Coord& destination) const
+{
+    int bestId = -1;
+    double bestDistance2 = getPlanarDistance2(self, destination);
+    for (const auto& entry : neighbours) {
+        double distance2 = getPlanarDistance2(entry.second.position, destination);
+        if (distance2 < bestDistance2 || (distance2 == bestDistance2 && bestId >= 0 && entry.first < bestId)) {
+            bestDistance2 = distance2;
+            bestId = entry.first;
+        }
+    }
+    return bestId;
+}
+
+bool LoRaGeoNeighbourTable::isGabrielEdge(const Coord& self, const Coord& neighbour) const
+{
+    // The edge survives if no other neighbour lies inside the circle with the edge as diameter
+    Coord middle((self.x + neighbour.x) / 2, (self.y + neighbour.y) / 2, 0);
+    double radius2 = getPlanarDistance2(self, neighbour) / 4;
+    for (const auto& entry : neighbours) {
+        const Coord& witness = entry.second.position;
+        if (witness.x == neighbour.x && witness.y == neighbour.y)
+            continue;
+        if (getPlanarDistance2(witness, middle) < radius2)
+            return false;
+    }
+    return true;
+}
+
+int LoRaGeoNeighbourTable::findPerimeterNextHop(const Coord& self, const Coord& reference) const
+{
+    double referenceBearing = atan2(reference.y - self.y, reference.x - self.x);
+    int bestId = -1;
+    double bestAngle = 0;
+    for (const auto& entry : neighbours) {
+        const Coord& position = entry.second.position;
+        if (!isGabrielEdge(self, position))
+            continue;
+        double angle = atan2(position.y - self.y, position.x - self.x) - referenceBearing;
+        while (angle <= 0)
+            angle += 2 * M_PI;
+        while (angle > 2 * M_PI)
+            angle -= 2 * M_PI;
+        // The previous hop itself comes last (angle 2*pi): going back is the last resort
+        if (bestId < 0 || angle < bestAngle || (angle == bestAngle && entry.first < bestId)) {
+            bestAngle = angle;
+            bestId = entry.first;
+        }
+    }
+    return bestId;
+}
+
+}
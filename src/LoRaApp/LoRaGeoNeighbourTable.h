@@ -0,0 +1,66 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#ifndef __LORA_OMNET_LORAGEONEIGHBOURTABLE_H_
+#define __LORA_OMNET_LORAGEONEIGHBOURTABLE_H_
+
+#include <omnetpp.h>
+#include <unordered_map>
+
+#include "inet/common/geometry/common/Coord.h"
+
+using namespace omnetpp;
+
+namespace inet {
+
+/**
+ * Positions of the one-hop neighbours of a node, learned from the transmitter
+ * position carried by every overheard frame, and the next-hop rules of
+ * greedy/perimeter geographic forwarding (GPSR). Only x and y are used.
+ */
+class LoRaGeoNeighbourTable
+{
+    protected:
+        struct Neighbour {
+            Coord position;
+            simtime_t lastHeard;
+        };
+        std::unordered_map<int, Neighbour> neighbours;
+
+        bool isGabrielEdge(const Coord& self, const Coord& neighbour) const;
+
+    public:
+        void update(int id, const Coord& position, simtime_t now);
+        void purge(simtime_t now, simtime_t timeout);
+        bool isEmpty() const { return neighbours.empty(); }
+        int getSize() const { return neighbours.size(); }
+
+        /**
+         * Neighbour closest to the destination among those strictly closer
+         * than this node, or -1 at a local maximum.
+         */
+        int findGreedyNextHop(const Coord& self, const Coord& destination) const;
+        /**
+         * Right-hand rule on the Gabriel-planarized neighbour graph: the first
+         * neighbour counterclockwise from the direction of the reference
+         * point, i.e. the destination when entering perimeter mode or the
+         * previous hop afterwards. Returns -1 without neighbours.
+         */
+        int findPerimeterNextHop(const Coord& self, const Coord& reference) const;
+};
+
+}
+
+#endif
@@ -3,6 +3,7 @@
 //
 
 #include "LoRaHardwareApp.h"
+#include "misc/LoRaScalarCollector.h"
 #include "inet/common/ModuleAccess.h"
 #include "inet/common/lifecycle/NodeOperations.h"
 #include <algorithm>
@@ -315,10 +316,10 @@ void LoRaHardwareApp::finish() {
     EV << "  Packets forwarded to sim: " << packetsForwardedToSim << endl;
     EV << "  Packets forwarded to HW: " << packetsForwardedToHW << endl;
     
-    recordScalar("packetsSentToHW", packetsSentToHW);
-    recordScalar("packetsReceivedFromHW", packetsReceivedFromHW);
-    recordScalar("packetsForwardedToSim", packetsForwardedToSim);
-    recordScalar("packetsForwardedToHW", packetsForwardedToHW);
+    LoRaScalarCollector::record(this, "packetsSentToHW", packetsSentToHW);
+    LoRaScalarCollector::record(this, "packetsReceivedFromHW", packetsReceivedFromHW);
+    LoRaScalarCollector::record(this, "packetsForwardedToSim", packetsForwardedToSim);
+    LoRaScalarCollector::record(this, "packetsForwardedToHW", packetsForwardedToHW);
 }
 
 bool LoRaHardwareApp::handleOperationStage(LifecycleOperation *operation, int stage, IDoneCallback *doneCallback) {
@@ -0,0 +1,72 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <algorithm>
+#include <cmath>
+
+#include "LoRaLinkTable.h"
+#include "LoRaPhy/LoRaLinkBudget.h"
+
+namespace inet {
+
+void LoRaLinkTable::setSmoothing(double smoothing)
+{
+    if (smoothing <= 0 || smoothing > 1)
+        throw cRuntimeError("Link smoothing must be in (0, 1]");
+    this->smoothing = smoothing;
+}
+
+void LoRaLinkTable::update(int id, double pathLossDb, simtime_t now)
+{
+    auto it = links.find(id);
+    if (it == links.end())
+        links[id] = Link{pathLossDb, now};
+    else {
+        it->second.pathLoss += smoothing * (pathLossDb - it->second.pathLoss);
+        it->second.lastHeard = now;
+    }
+}
+
+void LoRaLinkTable::purge(simtime_t now, simtime_t timeout)
+{
+    for (auto it = links.begin(); it != links.end(); ) {
+        if (now - it->second.lastHeard > timeout)
+            it = links.erase(it);
+        else
+            it++;
+    }
+}
+
+bool LoRaLinkTable::choose(int id, int minSF, int maxSF, double minTP, double maxTP, double bandwidthHz,
+        double marginDb, double sensitivityOffsetDb, int& sf, double& tp) const
+{
+    auto it = links.find(id);
+    if (it == links.end())
+        return false;
+    for (int candidate = minSF; candidate <= maxSF; candidate++) {
+        double sensitivity = physicallayer::linkbudget::loRaSensitivityDbm(candidate, bandwidthHz);
+        if (std::isnan(sensitivity))
+            continue;
+        double required = std::ceil(sensitivity + sensitivityOffsetDb + marginDb + it->second.pathLoss);
+        if (required <= maxTP) {
+            sf = candidate;
+            tp = std::max(minTP, required);
+            return true;
+        }
+    }
+    return false;
+}
+
+}
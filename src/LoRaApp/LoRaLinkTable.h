@@ -0,0 +1,62 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#ifndef __LORA_OMNET_LORALINKTABLE_H_
+#define __LORA_OMNET_LORALINKTABLE_H_
+
+#include <omnetpp.h>
+#include <unordered_map>
+
+using namespace omnetpp;
+
+namespace inet {
+
+/**
+ * Path loss to each one-hop neighbour, estimated from the transmit power and
+ * RSSI of the frames heard from it (links are assumed symmetric) and smoothed
+ * with an exponentially weighted moving average. Picks the cheapest SF and
+ * transmit power that still reach a neighbour with a given margin.
+ */
+class LoRaLinkTable
+{
+    protected:
+        struct Link {
+            double pathLoss;      // dB
+            simtime_t lastHeard;
+        };
+        std::unordered_map<int, Link> links;
+        double smoothing = 0.25;  // weight of the newest sample
+
+    public:
+        void setSmoothing(double smoothing);
+        void update(int id, double pathLossDb, simtime_t now);
+        void purge(simtime_t now, simtime_t timeout);
+        void clear() { links.clear(); }
+        int getSize() const { return links.size(); }
+
+        /**
+         * Lowest SF in [minSF, maxSF], and the lowest whole-dBm power in
+         * [minTP, maxTP] at that SF, whose predicted RSSI at the neighbour is
+         * at least marginDb above the sensitivity (plus sensitivityOffsetDb,
+         * e.g. CAD attenuation). Returns false for unknown neighbours and
+         * links that even maxSF at maxTP cannot close.
+         */
+        bool choose(int id, int minSF, int maxSF, double minTP, double maxTP, double bandwidthHz,
+                double marginDb, double sensitivityOffsetDb, int& sf, double& tp) const;
+};
+
+}
+
+#endif
@@ -14,6 +14,7 @@
 // 
 
 #include "LoRaMotoGWApp.h"
+#include "misc/LoRaScalarCollector.h"
 #include "../LoRa/LoRaMac.h"
 #include "../LoRa/LoRaMacFrame_m.h"
 
@@ -74,8 +75,8 @@ void LoRaMotoGWApp::initialize(int stage)
 void LoRaMotoGWApp::finish()
 {
     cModule *host = getContainingNode(this);
-    recordScalar("sentPackets", sentPackets);
-    recordScalar("receivedPackets", receivedPackets);
+    LoRaScalarCollector::record(this, "sentPackets", sentPackets);
+    LoRaScalarCollector::record(this, "receivedPackets", receivedPackets);
 }
 
 void LoRaMotoGWApp::handleMessage(cMessage *msg)
@@ -17,8 +17,11 @@
 #include <set>
 #include <cstdio> // snprintf for dynamic event names
 #include <climits> // INT_MAX for end-node filtering
+#include <bitset> // popcount of the ETX reception window
 
 #include "LoRaNodeApp.h"
+#include "LoRaNodeOperations.h"
+#include "misc/LoRaScalarCollector.h"
 #include "inet/common/FSMA.h"
 #include "../LoRa/LoRaMac.h"
 #include <sstream>
@@ -31,6 +34,7 @@
 
 
 #include "inet/mobility/static/StationaryMobility.h"
+#include "inet/common/lifecycle/NodeOperations.h"
 namespace inet {
 
 #define BROADCAST_ADDRESS   16777215
@@ -43,6 +47,7 @@ namespace inet {
 #define RSSI_SUM_SINGLE_SF            4
 #define RSSI_PROD_SINGLE_SF           5
 #define ETX_SINGLE_SF                 6
+#define GEOGRAPHIC_SINGLE_SF          7
 #define TIME_ON_AIR_HC_CAD_SF        11
 #define TIME_ON_AIR_SF_CAD_SF        12
 
@@ -140,6 +145,7 @@ void finalizeFailureLogIfNone() {
 // RSSI_SUM_SINGLE_SF (4)           : Single-metric; metric = sum of RSSI along path (higher raw RSSI -> lower derived cost assumed).
 // RSSI_PROD_SINGLE_SF (5)          : Single-metric; metric = product/aggregation of RSSI factors.
 // ETX_SINGLE_SF (6)                : Single-metric; metric = Expected Transmission Count (lower = more reliable path).
+// GEOGRAPHIC_SINGLE_SF (7)         : No routing tables; greedy/perimeter forwarding on node positions (see LoRaGeoNeighbourTable).
 // TIME_ON_AIR_HC_CAD_SF (11)       : Dual-metric; primary combines time-on-air + hop count + CAD attempts.
 // TIME_ON_AIR_SF_CAD_SF (12)       : Dual-metric; primary combines time-on-air + spreading factor + CAD attempts.
 // ---------------------------------------------------------------------------
@@ -261,6 +267,12 @@ void LoRaNodeApp::initialize(int stage) {
                 pf << "simTime,event,packetSeq,src,dst,currentNode,ttlAfterDecr,chosenVia,nextHopType" << std::endl;
                 pf.close();
             }
+            std::stringstream hss; hss << folder << sep << "hop_trails.csv";
+            std::ofstream hf(hss.str(), std::ios::out | std::ios::trunc);
+            if (hf.is_open()) {
+                hf << "simTime,packetSeq,src,dst,transmissions,latency,path,hopTimes" << std::endl;
+                hf.close();
+            }
             // Reset the flag used in ensurePathLogInitialized so it knows file already has header
             pathLogReady = false; // will be set true on first ensurePathLogInitialized() call
 
@@ -442,6 +454,7 @@ void LoRaNodeApp::initialize(int stage) {
         dutyCycle = par("dutyCycle");
         numberOfDestinationsPerNode = par("numberOfDestinationsPerNode");
         numberOfPacketsPerDestination = par("numberOfPacketsPerDestination");
+        lazyDataPackets = par("lazyDataPackets");
     bool forceSingleDestination = par("forceSingleDestination");
     int forcedDestinationId = par("forcedDestinationId");
 
@@ -472,10 +485,16 @@ void LoRaNodeApp::initialize(int stage) {
         loRaCAD = par("initialLoRaCAD");
         loRaCADatt = par("initialLoRaCADatt").doubleValue();
         evaluateADRinNode = par("evaluateADRinNode");
-        txSfVector.setName("Tx1 SF Vector");
-        txTpVector.setName("Tx1 TP Vector");
-        rxRssiVector.setName("Rx1 RSSI Vector");
-        rxSfVector.setName("Rx1 SF Vector");
+        LoRaStreamingStatistic::Mode txStatistic = LoRaStreamingStatistic::parseMode(par("txStatistic").stdstringValue());
+        LoRaStreamingStatistic::Mode rxStatistic = LoRaStreamingStatistic::parseMode(par("rxStatistic").stdstringValue());
+        int statisticDecimation = par("statisticDecimation");
+        txSfVector.setMode(txStatistic, "Tx1 SF Vector");
+        txTpVector.setMode(txStatistic, "Tx1 TP Vector", "dBm");
+        rxRssiVector.setMode(rxStatistic, "Rx1 RSSI Vector", "dBm");
+        rxRssiVector.setResolution(0.1);
+        rxSfVector.setMode(rxStatistic, "Rx1 SF Vector");
+        for (LoRaStreamingStatistic *statistic : {&txSfVector, &txTpVector, &rxRssiVector, &rxSfVector})
+            statistic->setDecimation(statisticDecimation);
 
         // DistanceX.setName("Distance X Vector");
 
@@ -595,14 +614,11 @@ void LoRaNodeApp::initialize(int stage) {
             selfRoute.via = nodeId;          // Direct route to self
             selfRoute.metric = 0;            // Zero hops to self
             selfRoute.valid = simTime() + 999999;  // Never expires
-            selfRoute.seqNum = ownSeqNum;    // Current sequence number
             selfRoute.isValid = true;
-            selfRoute.installTime = simTime();
-            // Initialize window array to 0
-            for (int i = 0; i < 33; i++) {
-                selfRoute.window[i] = 0;
-            }
+            selfRoute.window = 0;
+            selfRoute.windowLastSeq = 0;
             singleMetricRoutingTable.push_back(selfRoute);
+            setRouteSeqNum(nodeId, ownSeqNum);    // Current sequence number
             
             EV_WARN << ">>>>>>> [DSDV-INIT] Node " << nodeId << " added self-route to table, table size now: " 
                     << singleMetricRoutingTable.size() << " <<<<<<" << endl;
@@ -681,28 +697,13 @@ void LoRaNodeApp::initialize(int stage) {
                         << " (2.5 × incremental period)" << endl;
             }
 
-            // Schedule periodic DSDV timers with random jitter to avoid synchronization
-            // Jitter range: uniform(jitterMin, jitterMax)
-            simtime_t incrementalJitter = uniform(dsdvTimerJitterMin.dbl(), dsdvTimerJitterMax.dbl());
-            simtime_t fullJitter = uniform(dsdvTimerJitterMin.dbl(), dsdvTimerJitterMax.dbl());
-
-            simtime_t nextIncrementalUpdate = simTime() + dsdvIncrementalPeriod + incrementalJitter;
-            simtime_t nextFullUpdate = simTime() + dsdvFullUpdatePeriod + fullJitter;
-
-            // Create and schedule DSDV timer messages (use member variables)
-            dsdvIncrementalTimer = new cMessage("dsdvIncrementalTimer");
-            dsdvFullTimer = new cMessage("dsdvFullTimer");
-
-            EV_WARN << "[DEBUG-TIMER] Node " << nodeId << " scheduling dsdvIncrementalTimer for t=" << nextIncrementalUpdate << endl;
-            scheduleAt(nextIncrementalUpdate, dsdvIncrementalTimer);
-            EV_WARN << "[DEBUG-TIMER] Node " << nodeId << " scheduling dsdvFullTimer for t=" << nextFullUpdate << endl;
-            scheduleAt(nextFullUpdate, dsdvFullTimer);
+            scheduleDsdvTimers();
 
             EV_INFO << "[DSDV] Initialized DSDV routing protocol for node " << nodeId << endl;
             EV_INFO << "[DSDV]   Incremental period: " << dsdvIncrementalPeriod 
-                    << " (next at " << nextIncrementalUpdate << ")" << endl;
+                    << " (next at " << dsdvIncrementalTimer->getArrivalTime() << ")" << endl;
             EV_INFO << "[DSDV]   Full update period: " << dsdvFullUpdatePeriod 
-                    << " (next at " << nextFullUpdate << ")" << endl;
+                    << " (next at " << dsdvFullTimer->getArrivalTime() << ")" << endl;
             EV_INFO << "[DSDV]   Triggered min interval: " << dsdvTriggeredMinInterval << endl;
             EV_INFO << "[DSDV]   Route lifetime: " << dsdvRouteLifetime << endl;
             EV_INFO << "[DSDV]   Neighbor timeout: " << dsdvNeighborTimeout << endl;
@@ -827,7 +828,7 @@ void LoRaNodeApp::initialize(int stage) {
         neighbourNodes = {};
         knownNodes = {};
         LoRaPacketsToSend = {};
-        LoRaPacketsToForward = {};
+        LoRaPacketsToForward.clear();
         LoRaPacketsForwarded = {};
         DataPacketsForMe = {};
         ACKedNodes = {};
@@ -905,7 +906,7 @@ void LoRaNodeApp::initialize(int stage) {
             //WATCH_VECTOR(dualMetricRoutingTable);
 
             WATCH_VECTOR(LoRaPacketsToSend);
-            WATCH_VECTOR(LoRaPacketsToForward);
+            WATCH(LoRaPacketsToForward);
             WATCH_VECTOR(LoRaPacketsForwarded);
             WATCH_VECTOR(DataPacketsForMe);
         }
@@ -914,7 +915,16 @@ void LoRaNodeApp::initialize(int stage) {
             numberOfDestinationsPerNode = numberOfNodes-1;
             EV<< "printing node ID" << endl;
         }
-        generateDataPackets();
+        // Traffic models replace the up-front packet batch with arrivals from the shared wheel
+        trafficModel = LoRaTrafficModel::create(this);
+        if (trafficModel != nullptr && onlyNode0SendsPackets && originalNodeIndex != 0) {
+            delete trafficModel;
+            trafficModel = nullptr;
+        }
+        if (trafficModel != nullptr)
+            startTrafficModel();
+        else
+            generateDataPackets();
 
         // Routing packets timer (enforce a minimum start delay of 5s)
         {
@@ -927,6 +937,7 @@ void LoRaNodeApp::initialize(int stage) {
             case NO_FORWARDING:
             case FLOODING_BROADCAST_SINGLE_SF:
             case SMART_BROADCAST_SINGLE_SF:
+            case GEOGRAPHIC_SINGLE_SF:
                 break;
             // Schedule selfRoutingPackets
             default:
@@ -949,7 +960,7 @@ void LoRaNodeApp::initialize(int stage) {
         if (LoRaPacketsToSend.size() > 0) {
                     dataPacketsDue = true;
                     nextDataPacketTransmissionTime = timeToFirstDataPacket;
-                    EV_INFO << "[DATA-DEBUG] Node " << nodeId << ": " << LoRaPacketsToSend.size() 
+                    EV_INFO << "[DATA-DEBUG] Node " << nodeId << ": " << getPendingDataPacketCount() 
                             << " data packets generated, first scheduled at t=" << timeToFirstDataPacket << endl;
         } else {
                     EV_INFO << "[DATA-DEBUG] Node " << nodeId << ": no data packets to send" << endl;
@@ -972,9 +983,114 @@ void LoRaNodeApp::initialize(int stage) {
         selfPacket = new cMessage("selfPacket");
         selfPacket->setSchedulingPriority(-10);  // High priority: processed before mobility events (default priority is 0)
         EV_WARN << "[SELFPACKET-INIT] Node " << nodeId << " created selfPacket at t=" << simTime() << endl;
+
+        // Data-done tracking only matters when traffic is finite and routing beacons are to be stopped
+        {
+            cModule *host = getContainingNode(this);
+            dataDoneParticipant = !sendPacketsContinuously && trafficModel == nullptr && strcmp(host->getName(), "loRaNodes") == 0
+                    && host->getIndex() < numberOfNodes;
+        }
+        dataDoneCounted = false;
+        dataDoneLastActivity = 0;
+        if (dataDoneParticipant) {
+            if (globalNodesExpectingDataDone == 0)
+                globalNodesExpectingDataDone = numberOfNodes;
+            dataDoneTimer = new cMessage("dataDoneTimer");
+        }
+
+        // Forward queue scheduling
+        {
+            std::string scheduling = par("forwardScheduling").stdstringValue();
+            if (scheduling != "fifo" && scheduling != "drr")
+                throw cRuntimeError("Unknown forwardScheduling '%s' (fifo or drr)", scheduling.c_str());
+            fairForwarding = scheduling == "drr";
+            drrQuantum = par("forwardQuantum");
+            LoRaPacketsToForward.setScheduling(fairForwarding, drrQuantum);
+            recordFlowLatency = fairForwarding || par("flowLatencyStatistics").boolValue();
+            ownDataDeficit = forwardDeficit = 0;
+            ownDataTurn = true;
+            drrTurnStarted = false;
+        }
+
+        // Link adaptation
+        linkAdaptation = par("linkAdaptation");
+        linkAdaptationMargin = par("linkAdaptationMargin");
+        minLoRaTP = par("minLoRaTP").doubleValue();
+        linkTimeout = par("linkTimeout");
+        links.clear();
+        links.setSmoothing(par("linkSmoothing").doubleValue());
+        linkAdaptedFrames = 0;
+        linkAdaptationSFSaved = 0;
+        linkAdaptationTPSaved = 0;
+        if (linkAdaptation && !loRaCAD)
+            EV_WARN << "Link adaptation without CAD: only the transmit power is adapted" << endl;
+
+        // Implicit hop-by-hop ACKs
+        implicitAcks = par("implicitAcks");
+        implicitAckTimeout = par("implicitAckTimeout");
+        implicitAckMaxRetries = par("implicitAckMaxRetries");
+        implicitAcksHeard = hopRetransmissions = hopRetransmissionFailures = implicitAckRepeats = 0;
+        hopAcks.clear();
+        if (implicitAcks)
+            hopAckTimer = new cMessage("hopAckTimer");
+
+        // Relay aggregation
+        aggregateForwarding = par("aggregateForwardPackets");
+        aggregationMaxPayload = par("aggregationMaxPayload");
+        aggregationSubHeaderSize = par("aggregationSubHeaderSize");
+        aggregatedFramesSent = aggregatedPacketsSent = aggregatedFramesReceived = 0;
+
+        // Online flow statistics, optionally replacing the per-hop path log
+        pathLog = par("pathLog");
+        hopTrail = par("hopTrail");
+        if (par("flowStatisticsModule").stringValue()[0] != '\0')
+            flowStatistics = getModuleFromPar<LoRaFlowStatistics>(par("flowStatisticsModule"), this);
+
+        // Broadcast suppression policy for FLOODING/SMART_BROADCAST forwarding
+        {
+            std::string policy = par("broadcastSuppression").stdstringValue();
+            if (policy == "none")
+                broadcastSuppression = SUPPRESSION_NONE;
+            else if (policy == "counter")
+                broadcastSuppression = SUPPRESSION_COUNTER;
+            else if (policy == "distance")
+                broadcastSuppression = SUPPRESSION_DISTANCE;
+            else if (policy == "coverage")
+                broadcastSuppression = SUPPRESSION_COVERAGE;
+            else
+                throw cRuntimeError("Unknown broadcastSuppression '%s' (none, counter, distance or coverage)", policy.c_str());
+            suppressionAssessmentDelay = par("suppressionAssessmentDelay");
+            suppressionCounterThreshold = par("suppressionCounterThreshold");
+            suppressionRssiThreshold = par("suppressionRssiThreshold");
+            suppressionNeighbourTimeout = par("suppressionNeighbourTimeout");
+            broadcastsSuppressed = 0;
+            queuedBroadcastsCanceled = 0;
+            if (broadcastSuppression != SUPPRESSION_NONE)
+                broadcastAssessmentTimer = new cMessage("broadcastAssessmentTimer");
+        }
+
+        // Geographic forwarding: publish this node's mobility so that sources can address it by position
+        hostMobility = dynamic_cast<IMobility *>(getContainingNode(this)->getSubmodule("mobility"));
+        if (hostMobility != nullptr)
+            geoLocationModules[nodeId] = dynamic_cast<cModule *>(hostMobility)->getId();
+        geoNeighbourTimeout = par("geoNeighbourTimeout");
+        if (routingMetric == GEOGRAPHIC_SINGLE_SF && useDSDV)
+            throw cRuntimeError("Geographic forwarding (routingMetric 7) uses no routing tables; set routingProtocol = \"legacy\"");
+        if (routingMetric == GEOGRAPHIC_SINGLE_SF && hostMobility == nullptr)
+            throw cRuntimeError("Geographic forwarding (routingMetric 7) needs a \"mobility\" submodule implementing IMobility");
+
+        // Wake up on the MAC's IDLE transition rather than re-polling it every 20us while it is busy
+        waitForMacReady = par("waitForMacReady");
+        waitingForMacReady = false;
+        macBusyDeferrals = 0;
+        if (waitForMacReady) {
+            cModule *macModule = getParentModule()->getSubmodule("LoRaNic")->getSubmodule("mac");
+            macModule->subscribe(LoRaMac::macReadySignal, this);
+        }
         // Failure scheduling parameters (local + optional global subset override)
         timeToFailureParam = par("timeToFailure");
         failureJitterFracParam = par("failureJitterFrac");
+        failureCrashesNode = par("failureCrashesNode");
 
         // Global subset logic: only executed once globally, then applied per node
         initGlobalFailureSelection();
@@ -1006,7 +1122,7 @@ void LoRaNodeApp::initialize(int stage) {
         }
         if (timeToFailureParam >= 0 && !failureEvent) {
             EV_WARN << "[FailureDiag] WARNING: timeToFailureParam=" << timeToFailureParam << " but failureEvent not scheduled (unexpected)" << endl;
-            recordScalar("failureSchedulingAnomaly", 1);
+            LoRaScalarCollector::record(this, "failureSchedulingAnomaly", 1);
         }
 
         if (dataPacketsDue || forwardPacketsDue || routingPacketsDue) {
@@ -1112,23 +1228,35 @@ void LoRaNodeApp::finish() {
 //    recordScalar("positionX", coord.x);
 //    recordScalar("positionY", coord.y);
     // DistanceX.record(coord.x);
-    recordScalar("CordiX",coord.x);
+    LoRaScalarCollector::record(this, "CordiX",coord.x);
     // DistanceY.record(coord.y);
-    recordScalar("CordiY",coord.y);
+    LoRaScalarCollector::record(this, "CordiY",coord.y);
 
 
-    recordScalar("finalTP", loRaTP);
-    recordScalar("finalSF", loRaSF);
+    LoRaScalarCollector::record(this, "finalTP", loRaTP);
+    txSfVector.recordScalars(this, "txSF");
+    txTpVector.recordScalars(this, "txTP", "dBm");
+    rxRssiVector.recordScalars(this, "rxRSSI", "dBm");
+    rxSfVector.recordScalars(this, "rxSF");
+    LoRaScalarCollector::record(this, "finalSF", loRaSF);
 
     // Failure related scalars
-    recordScalar("failed", failed ? 1 : 0);
+    LoRaScalarCollector::record(this, "failed", failed ? 1 : 0);
     if (failureTime >= SIMTIME_ZERO)
-        recordScalar("failureTime", failureTime);
+        LoRaScalarCollector::record(this, "failureTime", failureTime);
+    if (recoveryCount > 0) {
+        LoRaScalarCollector::record(this, "recoveryCount", recoveryCount);
+        LoRaScalarCollector::record(this, "recoveryTime", recoveryTime);
+    }
+    if (recoveryEvent) {
+        cancelAndDelete(recoveryEvent);
+        recoveryEvent = nullptr;
+    }
     // Freeze related scalars
-    recordScalar("freezeValidityHorizon", freezeValidityHorizon.dbl());
-    recordScalar("routingFrozen", routingFrozen ? 1 : 0);
+    LoRaScalarCollector::record(this, "freezeValidityHorizon", freezeValidityHorizon.dbl());
+    LoRaScalarCollector::record(this, "routingFrozen", routingFrozen ? 1 : 0);
     if (routingFrozenTime >= SIMTIME_ZERO)
-        recordScalar("routingFrozenTime", routingFrozenTime);
+        LoRaScalarCollector::record(this, "routingFrozenTime", routingFrozenTime);
 
     // Export detailed routing tables only if explicitly enabled.
     // By default (parameter absent or false) we skip generating node_<id>_single.csv,
@@ -1143,63 +1271,105 @@ void LoRaNodeApp::finish() {
         finalizeFailureLogIfNone();
     }
 
-    recordScalar("sentPackets", sentPackets);
-    recordScalar("sentDataPackets", sentDataPackets);
-    recordScalar("sentRoutingPackets", sentRoutingPackets);
-    recordScalar("sentAckPackets", sentAckPackets);
-    recordScalar("receivedPackets", receivedPackets);
-    recordScalar("receivedPacketsForMe", receivedPacketsForMe);
-    recordScalar("receivedPacketsFromMe", receivedPacketsFromMe);
-    recordScalar("receivedPacketsToForward", receivedPacketsToForward);
-    recordScalar("receivedDataPackets", receivedDataPackets);
-    recordScalar("receivedDataPacketsForMe", receivedDataPacketsForMe);
-    recordScalar("receivedDataPacketsForMeUnique", receivedDataPacketsForMeUnique);
-    recordScalar("receivedDataPacketsFromMe", receivedDataPacketsFromMe);
-    recordScalar("receivedDataPacketsToForward", receivedDataPacketsToForward);
-    recordScalar("receivedDataPacketsToForwardCorrect",
+    LoRaScalarCollector::record(this, "sentPackets", sentPackets);
+    LoRaScalarCollector::record(this, "sentDataPackets", sentDataPackets);
+    LoRaScalarCollector::record(this, "sentRoutingPackets", sentRoutingPackets);
+    LoRaScalarCollector::record(this, "sentAckPackets", sentAckPackets);
+    LoRaScalarCollector::record(this, "receivedPackets", receivedPackets);
+    LoRaScalarCollector::record(this, "receivedPacketsForMe", receivedPacketsForMe);
+    LoRaScalarCollector::record(this, "receivedPacketsFromMe", receivedPacketsFromMe);
+    LoRaScalarCollector::record(this, "receivedPacketsToForward", receivedPacketsToForward);
+    LoRaScalarCollector::record(this, "receivedDataPackets", receivedDataPackets);
+    LoRaScalarCollector::record(this, "receivedDataPacketsForMe", receivedDataPacketsForMe);
+    LoRaScalarCollector::record(this, "receivedDataPacketsForMeUnique", receivedDataPacketsForMeUnique);
+    LoRaScalarCollector::record(this, "receivedDataPacketsFromMe", receivedDataPacketsFromMe);
+    LoRaScalarCollector::record(this, "receivedDataPacketsToForward", receivedDataPacketsToForward);
+    LoRaScalarCollector::record(this, "receivedDataPacketsToForwardCorrect",
             receivedDataPacketsToForwardCorrect);
-    recordScalar("receivedDataPacketsToForwardExpired",
+    LoRaScalarCollector::record(this, "receivedDataPacketsToForwardExpired",
             receivedDataPacketsToForwardExpired);
-    recordScalar("receivedDataPacketsToForwardUnique",
+    LoRaScalarCollector::record(this, "receivedDataPacketsToForwardUnique",
             receivedDataPacketsToForwardUnique);
-    recordScalar("receivedAckPacketsToForward", receivedAckPacketsToForward);
-    recordScalar("receivedAckPacketsToForwardCorrect",
+    LoRaScalarCollector::record(this, "receivedAckPacketsToForward", receivedAckPacketsToForward);
+    LoRaScalarCollector::record(this, "receivedAckPacketsToForwardCorrect",
             receivedAckPacketsToForwardCorrect);
-    recordScalar("receivedAckPacketsToForwardExpired",
+    LoRaScalarCollector::record(this, "receivedAckPacketsToForwardExpired",
             receivedAckPacketsToForwardExpired);
-    recordScalar("receivedAckPacketsToForwardUnique",
+    LoRaScalarCollector::record(this, "receivedAckPacketsToForwardUnique",
             receivedAckPacketsToForwardUnique);
-    recordScalar("receivedAckPackets", receivedAckPackets);
-    recordScalar("receivedAckPacketsForMe", receivedAckPacketsForMe);
-    recordScalar("receivedAckPacketsFromMe", receivedAckPacketsFromMe);
-    recordScalar("receivedADRCommands", receivedADRCommands);
-    recordScalar("forwardedPackets", forwardedPackets);
-    recordScalar("forwardedDataPackets", forwardedDataPackets);
-    recordScalar("forwardedAckPackets", forwardedAckPackets);
-    recordScalar("forwardPacketsDuplicateAvoid", forwardPacketsDuplicateAvoid);
-    recordScalar("packetsToForwardMaxVectorSize", packetsToForwardMaxVectorSize);
-    recordScalar("broadcastDataPackets", broadcastDataPackets);
-    recordScalar("broadcastForwardedPackets", broadcastForwardedPackets);
-
-    recordScalar("firstDataPacketTransmissionTime", firstDataPacketTransmissionTime);
-    recordScalar("lastDataPacketTransmissionTime", lastDataPacketTransmissionTime);
-    recordScalar("firstDataPacketReceptionTime", firstDataPacketReceptionTime);
-    recordScalar("lastDataPacketReceptionTime", lastDataPacketReceptionTime);
-
-    recordScalar("receivedADRCommands", receivedADRCommands);
-    recordScalar("AppACKReceived", AppACKReceived);
-    recordScalar("firstACK", firstACK);
-    recordScalar("firstACKSF", firstACKSF);
-
-    recordScalar("dataPacketsNotSent", LoRaPacketsToSend.size());
+    LoRaScalarCollector::record(this, "receivedAckPackets", receivedAckPackets);
+    LoRaScalarCollector::record(this, "receivedAckPacketsForMe", receivedAckPacketsForMe);
+    LoRaScalarCollector::record(this, "receivedAckPacketsFromMe", receivedAckPacketsFromMe);
+    LoRaScalarCollector::record(this, "receivedADRCommands", receivedADRCommands);
+    LoRaScalarCollector::record(this, "forwardedPackets", forwardedPackets);
+    LoRaScalarCollector::record(this, "forwardedDataPackets", forwardedDataPackets);
+    LoRaScalarCollector::record(this, "forwardedAckPackets", forwardedAckPackets);
+    LoRaScalarCollector::record(this, "forwardPacketsDuplicateAvoid", forwardPacketsDuplicateAvoid);
+    LoRaScalarCollector::record(this, "packetsToForwardMaxVectorSize", packetsToForwardMaxVectorSize);
+    LoRaScalarCollector::record(this, "broadcastDataPackets", broadcastDataPackets);
+    LoRaScalarCollector::record(this, "broadcastForwardedPackets", broadcastForwardedPackets);
+
+    LoRaScalarCollector::record(this, "firstDataPacketTransmissionTime", firstDataPacketTransmissionTime);
+    LoRaScalarCollector::record(this, "lastDataPacketTransmissionTime", lastDataPacketTransmissionTime);
+    LoRaScalarCollector::record(this, "firstDataPacketReceptionTime", firstDataPacketReceptionTime);
+    LoRaScalarCollector::record(this, "lastDataPacketReceptionTime", lastDataPacketReceptionTime);
+
+    LoRaScalarCollector::record(this, "receivedADRCommands", receivedADRCommands);
+    LoRaScalarCollector::record(this, "AppACKReceived", AppACKReceived);
+    LoRaScalarCollector::record(this, "firstACK", firstACK);
+    LoRaScalarCollector::record(this, "firstACKSF", firstACKSF);
+
+    LoRaScalarCollector::record(this, "dataPacketsNotSent", getPendingDataPacketCount());
     // FIX: forwardPacketsNotSent previously (incorrectly) used LoRaPacketsToSend.size()
-    recordScalar("forwardPacketsNotSent", LoRaPacketsToForward.size());
-
-    recordScalar("forwardBufferFull", forwardBufferFull);
+    LoRaScalarCollector::record(this, "forwardPacketsNotSent", LoRaPacketsToForward.size());
+
+    LoRaScalarCollector::record(this, "forwardBufferFull", forwardBufferFull);
+    LoRaScalarCollector::record(this, "forwardFlowsBacklogged", LoRaPacketsToForward.getNumBackloggedFlows());
+    LoRaScalarCollector::record(this, "macBusyDeferrals", macBusyDeferrals);
+    if (linkAdaptation) {
+        LoRaScalarCollector::record(this, "linkAdaptedFrames", linkAdaptedFrames);
+        LoRaScalarCollector::record(this, "linkAdaptationSFSaved", linkAdaptationSFSaved);
+        LoRaScalarCollector::record(this, "linkAdaptationTPSaved", linkAdaptationTPSaved);
+        LoRaScalarCollector::record(this, "linkNeighbours", links.getSize());
+    }
+    if (implicitAcks) {
+        LoRaScalarCollector::record(this, "implicitAcksHeard", implicitAcksHeard);
+        LoRaScalarCollector::record(this, "hopRetransmissions", hopRetransmissions);
+        LoRaScalarCollector::record(this, "hopRetransmissionFailures", hopRetransmissionFailures);
+        LoRaScalarCollector::record(this, "implicitAckRepeats", implicitAckRepeats);
+        LoRaScalarCollector::record(this, "hopAcksPending", hopAcks.size());
+    }
+    if (aggregateForwarding) {
+        LoRaScalarCollector::record(this, "aggregatedFramesSent", aggregatedFramesSent);
+        LoRaScalarCollector::record(this, "aggregatedPacketsSent", aggregatedPacketsSent);
+        LoRaScalarCollector::record(this, "aggregatedFramesReceived", aggregatedFramesReceived);
+    }
+    if (routingMetric == GEOGRAPHIC_SINGLE_SF) {
+        LoRaScalarCollector::record(this, "geoGreedyHops", geoGreedyHops);
+        LoRaScalarCollector::record(this, "geoPerimeterHops", geoPerimeterHops);
+        LoRaScalarCollector::record(this, "geoFallbackBroadcasts", geoFallbackBroadcasts);
+        LoRaScalarCollector::record(this, "geoPerimeterDrops", geoPerimeterDrops);
+        LoRaScalarCollector::record(this, "geoNeighbours", geoNeighbours.getSize());
+    }
+    if (hostMobility != nullptr) {
+        auto location = geoLocationModules.find(nodeId);
+        if (location != geoLocationModules.end() && location->second == dynamic_cast<cModule *>(hostMobility)->getId())
+            geoLocationModules.erase(location);
+    }
+    if (broadcastSuppression != SUPPRESSION_NONE) {
+        LoRaScalarCollector::record(this, "broadcastsSuppressed", broadcastsSuppressed);
+        LoRaScalarCollector::record(this, "queuedBroadcastsCanceled", queuedBroadcastsCanceled);
+    }
+    if (trafficModel != nullptr) {
+        LoRaScalarCollector::record(this, "trafficArrivals", trafficArrivals);
+        LoRaScalarCollector::record(this, "trafficAlarmReports", trafficAlarmReports);
+        delete trafficModel;
+        trafficModel = nullptr;
+    }
     // Strict unicast scalars
-    recordScalar("unicastNoRouteDrops", unicastNoRouteDrops);
-    recordScalar("unicastWrongNextHopDrops", unicastWrongNextHopDrops);
-    recordScalar("unicastFallbackBroadcasts", unicastFallbackBroadcasts);
+    LoRaScalarCollector::record(this, "unicastNoRouteDrops", unicastNoRouteDrops);
+    LoRaScalarCollector::record(this, "unicastWrongNextHopDrops", unicastWrongNextHopDrops);
+    LoRaScalarCollector::record(this, "unicastFallbackBroadcasts", unicastFallbackBroadcasts);
 
     // Replace unsafe erase-in-loop (iterator invalidation) with clear() operations.
     LoRaPacketsToSend.clear();
@@ -1207,40 +1377,64 @@ void LoRaNodeApp::finish() {
     LoRaPacketsForwarded.clear();
     DataPacketsForMe.clear();
 
-    recordScalar("dataPacketsForMeLatencyMax", dataPacketsForMeLatency.getMax());
-    recordScalar("dataPacketsForMeLatencyMean", dataPacketsForMeLatency.getMean());
-    recordScalar("dataPacketsForMeLatencyMin", dataPacketsForMeLatency.getMin());
-    recordScalar("dataPacketsForMeLatencyStdv", dataPacketsForMeLatency.getStddev());
-
-    recordScalar("dataPacketsForMeUniqueLatencyMax", dataPacketsForMeUniqueLatency.getMax());
-    recordScalar("dataPacketsForMeUniqueLatencyMean", dataPacketsForMeUniqueLatency.getMean());
-    recordScalar("dataPacketsForMeUniqueLatencyMin", dataPacketsForMeUniqueLatency.getMin());
-    recordScalar("dataPacketsForMeUniqueLatencyStdv", dataPacketsForMeUniqueLatency.getStddev());
-
-    recordScalar("routingTableSizeMax", routingTableSize.getMax());
-    recordScalar("routingTableSizeMean", routingTableSize.getMean());
-    recordScalar("routingTableSizeMin", routingTableSize.getMin());
-    recordScalar("routingTableSizeStdv", routingTableSize.getStddev());
-
-    recordScalar("allTxPacketsSFStatsMax", allTxPacketsSFStats.getMax());
-    recordScalar("allTxPacketsSFStatsMean", allTxPacketsSFStats.getMean());
-    recordScalar("allTxPacketsSFStatsMin", allTxPacketsSFStats.getMin());
-    recordScalar("allTxPacketsSFStatsStdv", allTxPacketsSFStats.getStddev());
-    recordScalar("routingTxPacketsSFStatsMax", routingTxPacketsSFStats.getMax());
-    recordScalar("routingTxPacketsSFStatsMean", routingTxPacketsSFStats.getMean());
-    recordScalar("routingTxPacketsSFStatsMin", routingTxPacketsSFStats.getMin());
-    recordScalar("routingTxPacketsSFStatsStdv", routingTxPacketsSFStats.getStddev());
-    recordScalar("owndataTxPacketsSFStatsMax", routingTxPacketsSFStats.getMax());
-    recordScalar("owndataTxPacketsSFStatsMean", routingTxPacketsSFStats.getMean());
-    recordScalar("owndataTxPacketsSFStatsMin", routingTxPacketsSFStats.getMin());
-    recordScalar("owndataTxPacketsSFStatsStdv", routingTxPacketsSFStats.getStddev());
-    recordScalar("fwdTxPacketsSFStatsMax", routingTxPacketsSFStats.getMax());
-    recordScalar("fwdTxPacketsSFStatsMean", routingTxPacketsSFStats.getMean());
-    recordScalar("fwdTxPacketsSFStatsMin", routingTxPacketsSFStats.getMin());
-    recordScalar("fwdTxPacketsSFStatsStdv", routingTxPacketsSFStats.getStddev());
-
-    dataPacketsForMeLatency.recordAs("dataPacketsForMeLatency");
-    dataPacketsForMeUniqueLatency.recordAs("dataPacketsForMeUniqueLatency");
+    LoRaScalarCollector::record(this, "dataPacketsForMeLatencyMax", dataPacketsForMeLatency.getMax());
+    LoRaScalarCollector::record(this, "dataPacketsForMeLatencyMean", dataPacketsForMeLatency.getMean());
+    LoRaScalarCollector::record(this, "dataPacketsForMeLatencyMin", dataPacketsForMeLatency.getMin());
+    LoRaScalarCollector::record(this, "dataPacketsForMeLatencyStdv", dataPacketsForMeLatency.getStddev());
+
+    LoRaScalarCollector::record(this, "dataPacketsForMeUniqueLatencyMax", dataPacketsForMeUniqueLatency.getMax());
+    LoRaScalarCollector::record(this, "dataPacketsForMeUniqueLatencyMean", dataPacketsForMeUniqueLatency.getMean());
+    LoRaScalarCollector::record(this, "dataPacketsForMeUniqueLatencyMin", dataPacketsForMeUniqueLatency.getMin());
+    LoRaScalarCollector::record(this, "dataPacketsForMeUniqueLatencyStdv", dataPacketsForMeUniqueLatency.getStddev());
+
+    LoRaScalarCollector::record(this, "routingTableSizeMax", routingTableSize.getMax());
+    LoRaScalarCollector::record(this, "routingTableSizeMean", routingTableSize.getMean());
+    LoRaScalarCollector::record(this, "routingTableSizeMin", routingTableSize.getMin());
+    LoRaScalarCollector::record(this, "routingTableSizeStdv", routingTableSize.getStddev());
+
+    LoRaScalarCollector::record(this, "allTxPacketsSFStatsMax", allTxPacketsSFStats.getMax());
+    LoRaScalarCollector::record(this, "allTxPacketsSFStatsMean", allTxPacketsSFStats.getMean());
+    LoRaScalarCollector::record(this, "allTxPacketsSFStatsMin", allTxPacketsSFStats.getMin());
+    LoRaScalarCollector::record(this, "allTxPacketsSFStatsStdv", allTxPacketsSFStats.getStddev());
+    LoRaScalarCollector::record(this, "routingTxPacketsSFStatsMax", routingTxPacketsSFStats.getMax());
+    LoRaScalarCollector::record(this, "routingTxPacketsSFStatsMean", routingTxPacketsSFStats.getMean());
+    LoRaScalarCollector::record(this, "routingTxPacketsSFStatsMin", routingTxPacketsSFStats.getMin());
+    LoRaScalarCollector::record(this, "routingTxPacketsSFStatsStdv", routingTxPacketsSFStats.getStddev());
+    LoRaScalarCollector::record(this, "owndataTxPacketsSFStatsMax", routingTxPacketsSFStats.getMax());
+    LoRaScalarCollector::record(this, "owndataTxPacketsSFStatsMean", routingTxPacketsSFStats.getMean());
+    LoRaScalarCollector::record(this, "owndataTxPacketsSFStatsMin", routingTxPacketsSFStats.getMin());
+    LoRaScalarCollector::record(this, "owndataTxPacketsSFStatsStdv", routingTxPacketsSFStats.getStddev());
+    LoRaScalarCollector::record(this, "fwdTxPacketsSFStatsMax", routingTxPacketsSFStats.getMax());
+    LoRaScalarCollector::record(this, "fwdTxPacketsSFStatsMean", routingTxPacketsSFStats.getMean());
+    LoRaScalarCollector::record(this, "fwdTxPacketsSFStatsMin", routingTxPacketsSFStats.getMin());
+    LoRaScalarCollector::record(this, "fwdTxPacketsSFStatsStdv", routingTxPacketsSFStats.getStddev());
+
+    LoRaScalarCollector::record(this, "dataPacketsForMeLatency", dataPacketsForMeLatency);
+    LoRaScalarCollector::record(this, "dataPacketsForMeUniqueLatency", dataPacketsForMeUniqueLatency);
+    // One histogram per flow ending here, named after its source, for fairness analysis
+    for (auto &flow : flowLatency)
+        LoRaScalarCollector::record(this, ("flowLatency-" + std::to_string(flow.first)).c_str(), flow.second);
+
+    if (routingJournalReady) {
+        logRoutingJournal("finish");
+        routingJournal.close();
+        routingJournalReady = false;
+    }
+
+    if (dataDoneTimer) {
+        cancelAndDelete(dataDoneTimer);
+        dataDoneTimer = nullptr;
+    }
+    if (broadcastAssessmentTimer) {
+        cancelAndDelete(broadcastAssessmentTimer);
+        broadcastAssessmentTimer = nullptr;
+    }
+    broadcastAssessments.clear();
+    if (hopAckTimer) {
+        cancelAndDelete(hopAckTimer);
+        hopAckTimer = nullptr;
+    }
+    hopAcks.clear();
 
     // Cleanup DSDV timers
     if (dsdvIncrementalTimer) {
@@ -1262,6 +1456,15 @@ void LoRaNodeApp::handleMessage(cMessage *msg) {
         // double-deletes later (e.g., finish() cleanup).
         if (msg == dsdvIncrementalTimer) dsdvIncrementalTimer = nullptr;
         if (msg == dsdvFullTimer) dsdvFullTimer = nullptr;
+        // A failed node stops sending/receiving, so it still becomes "done" once its timestamps age out
+        if (msg == dataDoneTimer) {
+            handleDataDoneTimer();
+            return;
+        }
+        if (msg == recoveryEvent) {
+            performRecovery();
+            return;
+        }
         delete msg;
         return;
     }
@@ -1287,6 +1490,21 @@ void LoRaNodeApp::handleSelfMessage(cMessage *msg) {
         return;
     }
 
+    if (msg == dataDoneTimer) {
+        handleDataDoneTimer();
+        return;
+    }
+
+    if (msg == broadcastAssessmentTimer) {
+        releaseAssessedBroadcasts();
+        return;
+    }
+
+    if (msg == hopAckTimer) {
+        retransmitUnacknowledged();
+        return;
+    }
+
     if (failed) {
         return; // Ignore timers after failure
     }
@@ -1378,7 +1596,7 @@ void LoRaNodeApp::handleSelfMessage(cMessage *msg) {
         EV_INFO << "[CONVERGENCE-DEBUG] Node " << nodeId << " state: dataPacketsDue=" << dataPacketsDue 
                 << ", forwardPacketsDue=" << forwardPacketsDue 
                 << ", routingPacketsDue=" << routingPacketsDue 
-                << ", dataQueueSize=" << LoRaPacketsToSend.size() 
+                << ", dataQueueSize=" << getPendingDataPacketCount() 
                 << ", forwardQueueSize=" << LoRaPacketsToForward.size() << endl;
         
         // Mark that this node has handled convergence
@@ -1435,7 +1653,7 @@ void LoRaNodeApp::handleSelfMessage(cMessage *msg) {
     if (nodeId < 50 || nodeId >= 1000) {
         EV_WARN << "[SELFPACKET-HANDLE] Node " << nodeId << " handleSelfMessage at t=" << simTime() 
                 << " MAC=" << lrmc->fsm.getState() 
-                << " dataQ=" << LoRaPacketsToSend.size()
+                << " dataQ=" << getPendingDataPacketCount()
                 << " fwdQ=" << LoRaPacketsToForward.size() << endl;
     }
     
@@ -1485,7 +1703,7 @@ void LoRaNodeApp::handleSelfMessage(cMessage *msg) {
             EV_INFO << "[PACKET-DECISION] Node " << nodeId << " at t=" << simTime() 
                     << ": sendDsdv=" << sendDsdv << " sendData=" << sendData 
                     << " sendForward=" << sendForward << " sendRouting=" << sendRouting 
-                    << " | dataQueue=" << LoRaPacketsToSend.size() 
+                    << " | dataQueue=" << getPendingDataPacketCount() 
                     << " forwardQueue=" << LoRaPacketsToForward.size() << endl;
         }
         
@@ -1567,9 +1785,9 @@ void LoRaNodeApp::handleSelfMessage(cMessage *msg) {
         else if (sendData || sendForward) {
 
             // If both data and forward packets are due, decide randomly between the two with the probability from the
-            // ownDataPriority parameter
+            // ownDataPriority parameter, or by deficit round robin with fair forwarding
             if (sendData && sendForward) {
-                if (bernoulli(ownDataPriority))
+                if (fairForwarding ? isOwnDataTurn() : bernoulli(ownDataPriority))
                     // Send own data packet
                     sendForward = false;
                 else
@@ -1581,15 +1799,17 @@ void LoRaNodeApp::handleSelfMessage(cMessage *msg) {
             if (sendData) {
 
                 txDuration = sendDataPacket();
+                // With a traffic model the arrivals already carry the timing, so only the airtime spaces packets
+                double dataPacketSpacing = trafficModel != nullptr ? 0 : getTimeToNextDataPacket().dbl();
                 if (enforceDutyCycle) {
                     // Update duty cycle end
                     dutyCycleEnd = simTime() + txDuration/dutyCycle;
                     // Update next data packet transmission time, taking the duty cycle into account
-                    nextDataPacketTransmissionTime = simTime() + std::max(getTimeToNextDataPacket().dbl(), txDuration.dbl()/dutyCycle);
+                    nextDataPacketTransmissionTime = simTime() + std::max(dataPacketSpacing, txDuration.dbl()/dutyCycle);
                 }
                 else {
                     // Update next data packet transmission time
-                    nextDataPacketTransmissionTime = simTime() + std::max(getTimeToNextDataPacket().dbl(), txDuration.dbl());
+                    nextDataPacketTransmissionTime = simTime() + std::max(dataPacketSpacing, txDuration.dbl());
                 }
             }
             // or send forward packet
@@ -1655,50 +1875,75 @@ void LoRaNodeApp::handleSelfMessage(cMessage *msg) {
                     << ": NOT scheduling selfPacket (no packets due)" << endl;
         }
 
-        if (!sendPacketsContinuously && routingPacketsDue) {
-
-            bool allNodesDone = true;
-
-            for (int i=0; i<numberOfNodes; i++) {
-                LoRaNodeApp *lrndpp = (LoRaNodeApp *) getParentModule()->getParentModule()->getSubmodule("loRaNodes", i)->getSubmodule("LoRaNodeApp");
-                if ( !(lrndpp->lastDataPacketTransmissionTime > 0 && \
-                     // ToDo: maybe too restrictive? If no packets were received at all
-                     // simulation laster until the very end
-                     //lrndpp->lastDataPacketReceptionTime > 0 &&
-                     lrndpp->lastDataPacketTransmissionTime + stopRoutingAfterDataDone < simTime() && \
-                     lrndpp->lastDataPacketReceptionTime + stopRoutingAfterDataDone < simTime() )) {
-                    allNodesDone = false;
-                    break;
-                }
-
-                if (allNodesDone) {
-                    routingPacketsDue = false;
-                }
-            }
+        // Stop routing once every node is done with its data (see updateDataDoneTracker())
+        if (!sendPacketsContinuously && routingPacketsDue && globalDataDoneFired) {
+            routingPacketsDue = false;
         }
     }
 
 
     // The LoRa radio was busy with a reception, so re-schedule the selfMessage a bit later
     else {
+        macBusyDeferrals++;
         // DEBUG: Log when MAC is busy for relay/end nodes with forward queue
         if ((nodeId < 50 || nodeId >= 1000) && LoRaPacketsToForward.size() > 0) {
             EV_WARN << "[SELFPACKET-MAC-BUSY] Node " << nodeId << " at t=" << simTime() 
                     << " MAC=" << lrmc->fsm.getState() 
                     << " fwdQ=" << LoRaPacketsToForward.size() 
-                    << " rescheduling in 20us" << endl;
+                    << (waitForMacReady ? " parking until MAC is ready" : " rescheduling in 20us") << endl;
+        }
+        if (waitForMacReady) {
+            // Park the pending transmission; receiveSignal(macReady) wakes selfPacket exactly once
+            waitingForMacReady = true;
+        }
+        else {
+            // Instead of doing scheduling almost immediately: scheduleAt(simTime() + 10*simTimeResolution, selfPacket);
+            // wait 20 microseconds, which is approx. the transmission time for 1 bit (SF7, 125 kHz, 4:5)
+            scheduleAt(simTime() + 0.00002, selfPacket);
         }
-        // Instead of doing scheduling almost immediately: scheduleAt(simTime() + 10*simTimeResolution, selfPacket);
-        // wait 20 microseconds, which is approx. the transmission time for 1 bit (SF7, 125 kHz, 4:5)
-        scheduleAt(simTime() + 0.00002, selfPacket);
+    }
+}
+
+void LoRaNodeApp::receiveSignal(cComponent *source, simsignal_t signalID, bool b, cObject *details) {
+    Enter_Method_Silent();
+
+    if (signalID != LoRaMac::macReadySignal || !waitingForMacReady)
+        return;
+    waitingForMacReady = false;
+
+    if (failed || !selfPacket)
+        return;
+    // Some other path (DSDV timer, new forward packet...) may already have rescheduled selfPacket
+    if (!selfPacket->isScheduled()) {
+        // The MAC is still inside its FSM here, so hand the packet down in a separate event
+        scheduleAt(simTime() + 10*simTimeResolution, selfPacket);
     }
 }
 
 void LoRaNodeApp::handleMessageFromLowerLayer(cMessage *msg) {
     if (failed) { delete msg; return; }
-    receivedPackets++;
 
     LoRaAppPacket *packet = check_and_cast<LoRaAppPacket *>(msg);
+    if (packet->getAggregatedArraySize() > 0)
+        unpackAggregatedFrame(packet);
+    receivedPackets++;
+
+    // Neighbour-coverage suppression needs to know who is in range
+    if (broadcastSuppression == SUPPRESSION_COVERAGE && packet->getLastHop() >= 0)
+        heardNeighbours[packet->getLastHop()] = simTime();
+    // Geographic forwarding learns neighbour positions from every frame it hears
+    if (routingMetric == GEOGRAPHIC_SINGLE_SF && packet->getLastHop() >= 0)
+        geoNeighbours.update(packet->getLastHop(), Coord(packet->getLastHopX(), packet->getLastHopY(), 0), simTime());
+    if (!unpackingAggregatedFrame) {
+        rxRssiVector.collect(packet->getOptions().getRSSI());
+        rxSfVector.collect(packet->getOptions().getLoRaSF());
+    }
+    // Every frame heard refreshes the path loss to its transmitter (once per aggregated frame)
+    if (linkAdaptation && packet->getLastHop() >= 0 && !unpackingAggregatedFrame)
+        links.update(packet->getLastHop(), packet->getOptions().getLoRaTP() - packet->getOptions().getRSSI(), simTime());
+    // Hearing the next hop forward a packet acknowledges it
+    if (!hopAcks.empty())
+        acknowledgeImplicitly(packet);
 
     // Check if the packet is from this node (i.e., a packet that some
     // other node is broadcasting which we have happened to receive). We
@@ -1772,6 +2017,7 @@ void LoRaNodeApp::handleMessageFromLowerLayer(cMessage *msg) {
         }
     }
 
+    updateDataDoneTracker();
     delete msg;
 }
 
@@ -1840,11 +2086,12 @@ void LoRaNodeApp::manageReceivedRoutingPacket(cMessage *msg) {
                     newRoute.via = sender;
                     newRoute.metric = computedMetric;
                     newRoute.valid = simTime() + par("dsdvRouteLifetime").doubleValue();
-                    newRoute.seqNum = receivedSeqNum;
                     newRoute.isValid = true;
-                    newRoute.installTime = simTime();
+                    newRoute.window = 0;
+                    newRoute.windowLastSeq = 0;
 
                     singleMetricRoutingTable.push_back(newRoute);
+                    setRouteSeqNum(destId, receivedSeqNum);
                     changedSet.insert(destId);
 
                     EV_INFO << "[DSDV] Installed new route to " << destId 
@@ -1854,7 +2101,7 @@ void LoRaNodeApp::manageReceivedRoutingPacket(cMessage *msg) {
                 } else {
                     // Existing route found - apply DSDV update rules
                     auto &existingRoute = singleMetricRoutingTable[existingIdx];
-                    int existingSeqNum = existingRoute.seqNum;
+                    int existingSeqNum = getRouteSeqNum(destId);
                     int existingMetric = existingRoute.metric;
 
                     bool shouldUpdate = false;
@@ -1881,8 +2128,7 @@ void LoRaNodeApp::manageReceivedRoutingPacket(cMessage *msg) {
                             // Mark route as invalid but keep in table
                             existingRoute.isValid = false;
                             existingRoute.metric = INFINITE_METRIC;
-                            existingRoute.seqNum = receivedSeqNum;
-                            existingRoute.installTime = simTime();
+                            setRouteSeqNum(destId, receivedSeqNum);
                             changedSet.insert(destId);
                             
                             EV_INFO << "[DSDV] Marked route to " << destId << " as unreachable "
@@ -1891,10 +2137,9 @@ void LoRaNodeApp::manageReceivedRoutingPacket(cMessage *msg) {
                             // Update to better/newer route
                             existingRoute.via = sender;
                             existingRoute.metric = computedMetric;
-                            existingRoute.seqNum = receivedSeqNum;
                             existingRoute.isValid = true;
                             existingRoute.valid = simTime() + par("dsdvRouteLifetime").doubleValue();
-                            existingRoute.installTime = simTime();
+                            setRouteSeqNum(destId, receivedSeqNum);
                             changedSet.insert(destId);
 
                             EV_INFO << "[DSDV] Updated route to " << destId 
@@ -2032,6 +2277,11 @@ void LoRaNodeApp::manageReceivedRoutingPacket(cMessage *msg) {
                 bubble("Discarding routing packet as forwarding is broadcast-based");
                 break;
 
+            // Forwarding is position-based
+            case GEOGRAPHIC_SINGLE_SF:
+                bubble("Discarding routing packet as forwarding is geographic");
+                break;
+
             case HOP_COUNT_SINGLE_SF:
             case RSSI_SUM_SINGLE_SF:
             case RSSI_PROD_SINGLE_SF:
@@ -2055,11 +2305,9 @@ void LoRaNodeApp::manageReceivedRoutingPacket(cMessage *msg) {
                                 break;
                             case ETX_SINGLE_SF:
                                 newNeighbour.metric = 1;
-                                newNeighbour.window[0] = packet->getDataInt();
-                                // Fill window[1] and beyond, until windowSizeth element, with 0's
-                                for (int i = 1; i<windowSize; i++) {
-                                    newNeighbour.window[i] = 0;
-                                }
+                                // No history yet: assume the previous windowSize packets were received
+                                newNeighbour.window = ~std::uint64_t(0);
+                                newNeighbour.windowLastSeq = packet->getDataInt();
                                 break;
                         }
 
@@ -2086,18 +2334,20 @@ void LoRaNodeApp::manageReceivedRoutingPacket(cMessage *msg) {
                                 break;
                             // Metric must be recalculated and window must be updated
                             case ETX_SINGLE_SF:
-                                int metric = 1;
-                                // Calculate the metric based on the window of previously received routing packets and update it
-                                for (int i=0; i<windowSize; i++) {
-                                    metric = metric + (packet->getDataInt() - (singleMetricRoutingTable[routeIndex].window[i] + i + 1));
-                                }
-                                singleMetricRoutingTable[routeIndex].metric = std::max(1, metric);
-                                // Update the window
-                                for (int i=windowSize; i>0; i--) {
-                                    singleMetricRoutingTable[routeIndex].window[i] = singleMetricRoutingTable[routeIndex].window[i-1];
+                            {
+                                singleMetricRoute &r = singleMetricRoutingTable[routeIndex];
+                                // Slide the reception bitmap by the sequence gap; every skipped number is a lost packet
+                                int gap = packet->getDataInt() - r.windowLastSeq;
+                                if (gap > 0) {
+                                    r.window = (gap >= 64) ? 1 : ((r.window << gap) | 1);
+                                    r.windowLastSeq = packet->getDataInt();
                                 }
-                                singleMetricRoutingTable[routeIndex].window[0] = packet->getDataInt();
+                                // Metric is 1 plus the packets lost among the last windowSize routing packets
+                                std::uint64_t mask = (std::uint64_t(1) << windowSize) - 1;
+                                int received = (int) std::bitset<64>(r.window & mask).count();
+                                r.metric = 1 + windowSize - received;
                                 break;
+                            }
                         }
                      }
                 }
@@ -2560,6 +2810,55 @@ void LoRaNodeApp::tryStopRoutingGlobally() {
 
 
 
+// Called whenever this node's data TX/RX timestamps may have moved. O(1): at most one timer
+// (re)arm and one counter update, instead of every node scanning every other node on each send.
+void LoRaNodeApp::updateDataDoneTracker() {
+    if (!dataDoneParticipant || !dataDoneTimer || globalDataDoneFired) {
+        return;
+    }
+    // A node that has not sent its own data yet can never be done
+    if (!(lastDataPacketTransmissionTime > 0)) {
+        return;
+    }
+    // Called for every received frame: routing beacons and ACKs leave the data timestamps alone
+    simtime_t lastActivity = std::max(lastDataPacketTransmissionTime, lastDataPacketReceptionTime);
+    if (lastActivity == dataDoneLastActivity) {
+        return;
+    }
+    dataDoneLastActivity = lastActivity;
+    // New activity after being counted done: leave the done set again
+    if (dataDoneCounted) {
+        dataDoneCounted = false;
+        globalNodesDataDone--;
+    }
+    // Lazy timer: handleDataDoneTimer() re-arms it if the timestamps moved meanwhile
+    if (!dataDoneTimer->isScheduled()) {
+        simtime_t doneAt = std::max(lastDataPacketTransmissionTime, lastDataPacketReceptionTime) + stopRoutingAfterDataDone;
+        scheduleAt(std::max(doneAt, simTime()) + 10*simTimeResolution, dataDoneTimer);
+    }
+}
+
+void LoRaNodeApp::handleDataDoneTimer() {
+    if (globalDataDoneFired || dataDoneCounted) {
+        return;
+    }
+    simtime_t doneAt = std::max(lastDataPacketTransmissionTime, lastDataPacketReceptionTime) + stopRoutingAfterDataDone;
+    if (!(doneAt < simTime())) {
+        scheduleAt(doneAt + 10*simTimeResolution, dataDoneTimer);
+        return;
+    }
+    dataDoneCounted = true;
+    globalNodesDataDone++;
+    EV_INFO << "Node " << nodeId << " done with data traffic (" << globalNodesDataDone << "/"
+            << globalNodesExpectingDataDone << ")" << endl;
+    if (globalNodesDataDone >= globalNodesExpectingDataDone) {
+        globalDataDoneFired = true;
+        EV_WARN << ">>>>>> ALL NODES DONE WITH DATA at t=" << simTime()
+                << " - routing packets will stop <<<<<<" << endl;
+    }
+}
+
+
 void LoRaNodeApp::openRoutingCsv() {
     // Build folder and file name: simulations folder is the working dir; create "routing_tables" subfolder
 #ifdef _WIN32
@@ -2575,11 +2874,34 @@ void LoRaNodeApp::openRoutingCsv() {
     mkdir(folder.c_str(), 0775);
 #endif
 
+    routingLogMode = par("routingLogMode").stdstringValue();
+    if (routingLogMode == "none") {
+        routingCsvReady = false;
+        return;
+    }
+
     // File name includes nodeId
     std::stringstream ss;
     ss << folder << sep << "node_" << nodeId << "_routing.csv";
     routingCsvPath = ss.str();
     routingCsvReady = true;
+
+    if (routingLogMode == "journal") {
+        // One long-lived, buffered stream per node; rows are flushed by the buffer, not per line
+        std::stringstream js;
+        js << folder << sep << "node_" << nodeId << "_routing_journal.csv";
+        routingJournalBuffer.resize(1 << 16);
+        routingJournal.rdbuf()->pubsetbuf(routingJournalBuffer.data(), routingJournalBuffer.size());
+        routingJournal.open(js.str(), std::ios::out | std::ios::trunc);
+        routingJournalReady = routingJournal.is_open();
+        if (routingJournalReady) {
+            routingJournal << "simTime,event,op,nodeId,id,via,sf,metric,priMetric,secMetric,validUntil,seqNum,isValid\n";
+        } else {
+            EV_WARN << "Node " << nodeId << " could not open routing journal " << js.str() << endl;
+        }
+    } else if (routingLogMode != "snapshot") {
+        throw cRuntimeError("Unknown routingLogMode '%s' (expected snapshot, journal or none)", routingLogMode.c_str());
+    }
 }
 
 
@@ -2669,6 +2991,8 @@ void LoRaNodeApp::ensurePathLogInitialized() {
 
 // Log each hop (transmission decision) for every data packet
 void LoRaNodeApp::logPathHop(const LoRaAppPacket *packet, const char *eventTag) {
+    if (!pathLog)
+        return;
     EV << "DEBUG: logPathHop called for node " << nodeId << ", event: " << eventTag << ", packet src=" << packet->getSource() << ", dst=" << packet->getDestination() << endl;
     std::cout << "DEBUG: logPathHop called for node " << nodeId << ", event: " << eventTag << ", packet src=" << packet->getSource() << ", dst=" << packet->getDestination() << std::endl;
     
@@ -2694,9 +3018,39 @@ void LoRaNodeApp::logPathHop(const LoRaAppPacket *packet, const char *eventTag)
     f.close();
 }
 
+// One row per delivered DATA packet with the path it carried: "src>relay>...>dst" and the
+// send time of every hop; "..." marks hops beyond the capacity of the trail
+void LoRaNodeApp::logHopTrail(const LoRaAppPacket *packet) {
+    std::ofstream f("delivered_packets/hop_trails.csv", std::ios::out | std::ios::app);
+    if (!f.is_open()) return;
+    const LoRaHopTrail &trail = packet->getHopTrail();
+    int stored = std::min(trail.getLength(), (int)trail.getNodeArraySize());
+    std::stringstream path, times;
+    for (int i = 0; i < stored; i++) {
+        path << trail.getNode(i) << '>';
+        times << (i ? ";" : "") << trail.getTime(i);
+    }
+    if (trail.getLength() > stored)
+        path << "...>";
+    path << nodeId;
+    f << simTime() << ","
+      << packet->getDataInt() << ","
+      << packet->getSource() << ","
+      << packet->getDestination() << ","
+      << trail.getLength() << ","
+      << simTime() - packet->getDepartureTime() << ","
+      << path.str() << ","
+      << times.str()
+      << std::endl;
+}
+
 
 void LoRaNodeApp::logRoutingSnapshot(const char *eventName) {
     if (!routingCsvReady) return;
+    if (routingJournalReady) {
+        logRoutingJournal(eventName);
+        return;
+    }
     // Open file in truncate mode to reflect current snapshot
     routingCsv.open(routingCsvPath, std::ios::out | std::ios::trunc);
     if (!routingCsv.is_open()) return;
@@ -2713,6 +3067,7 @@ void LoRaNodeApp::logRoutingSnapshot(const char *eventName) {
         case RSSI_SUM_SINGLE_SF: metricName = "RSSI_SUM"; break;
         case RSSI_PROD_SINGLE_SF: metricName = "RSSI_PROD"; break;
         case ETX_SINGLE_SF: metricName = "ETX"; break;
+        case GEOGRAPHIC_SINGLE_SF: metricName = "GEOGRAPHIC"; break;
         case TIME_ON_AIR_HC_CAD_SF: metricName = "TOA_HC"; break;
         case TIME_ON_AIR_SF_CAD_SF: metricName = "TOA"; break;
         default: metricName = "UNKNOWN"; break;
@@ -2732,7 +3087,7 @@ void LoRaNodeApp::logRoutingSnapshot(const char *eventName) {
                    << ",sf="
                    << ",priMetric="
                    << ",secMetric="
-                   << ",seqNum=" << r.seqNum
+                   << ",seqNum=" << getRouteSeqNum(r.id)
                    << ",isValid=" << (r.isValid ? "true" : "false")
 
                    << std::endl;
@@ -2759,6 +3114,68 @@ void LoRaNodeApp::logRoutingSnapshot(const char *eventName) {
     routingCsv.close();
 }
 
+// Journal mode: diff both routing tables against the last journalled state and append one
+// ADD / UPD / DEL row per changed route, so the cost of a call is proportional to what changed
+// on disk instead of the full table being rewritten.
+void LoRaNodeApp::logRoutingJournal(const char *eventName) {
+    unsigned generation = ++routingJournalGeneration;
+
+    auto journalRoute = [&](const std::tuple<int, int, int> &key, const routingJournalRow &row) {
+        auto it = routingJournalShadow.find(key);
+        if (it == routingJournalShadow.end()) {
+            routingJournalShadow[key] = row;
+            writeRoutingJournalRow(eventName, "ADD", key, row);
+            return;
+        }
+        routingJournalRow &old = it->second;
+        bool changed = old.metric != row.metric || old.priMetric != row.priMetric
+                || old.secMetric != row.secMetric || old.valid != row.valid
+                || old.seqNum != row.seqNum || old.isValid != row.isValid;
+        old = row;
+        if (changed) {
+            writeRoutingJournalRow(eventName, "UPD", key, row);
+        }
+    };
+
+    for (const auto &r : singleMetricRoutingTable) {
+        routingJournalRow row = {r.metric, 0, 0, r.valid, getRouteSeqNum(r.id), r.isValid, generation};
+        journalRoute(std::make_tuple(r.id, r.via, -1), row);
+    }
+    for (const auto &r : dualMetricRoutingTable) {
+        routingJournalRow row = {0, r.priMetric, r.secMetric, r.valid, 0, true, generation};
+        journalRoute(std::make_tuple(r.id, r.via, r.sf), row);
+    }
+
+    // Anything not seen in this pass was expired or replaced
+    for (auto it = routingJournalShadow.begin(); it != routingJournalShadow.end(); ) {
+        if (it->second.generation != generation) {
+            writeRoutingJournalRow(eventName, "DEL", it->first, it->second);
+            it = routingJournalShadow.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void LoRaNodeApp::writeRoutingJournalRow(const char *eventName, const char *op, const std::tuple<int, int, int> &key, const routingJournalRow &row) {
+    int sf = std::get<2>(key);
+    routingJournal << simTime() << ","
+                   << eventName << ","
+                   << op << ","
+                   << nodeId << ","
+                   << std::get<0>(key) << ","
+                   << std::get<1>(key) << ",";
+    if (sf < 0) {
+        routingJournal << "," << row.metric << ",,,";
+    } else {
+        routingJournal << sf << ",," << row.priMetric << "," << row.secMetric << ",";
+    }
+    routingJournal << row.valid << ","
+                   << row.seqNum << ","
+                   << (row.isValid ? "true" : "false")
+                   << "\n";
+}
+
 void LoRaNodeApp::manageReceivedPacketToForward(cMessage *msg) {
     // End nodes operate as sources/sinks only; they do not forward others' packets
     if (isEndNodeHost(this)) { delete msg; return; }
@@ -2927,11 +3344,22 @@ void LoRaNodeApp::manageReceivedDataPacketToForward(cMessage *msg) {
             case TIME_ON_AIR_HC_CAD_SF:
             case TIME_ON_AIR_SF_CAD_SF:
             default:
-                // Check if the packet has already been forwarded
-                if (isPacketForwarded(packet)) {
+                // A retransmission addressed to us of a packet we already forwarded: the sender did
+                // not overhear our forward, so forward it again
+                if (implicitAcks && packet->getVia() == nodeId && isPacketForwarded(packet) && !isPacketToBeForwarded(packet)) {
+                    forgetForwardedPacket(packet);
+                    implicitAckRepeats++;
+                }
+                // Check if the packet has already been forwarded (a perimeter walk may pass here again)
+                if (isPacketForwarded(packet) && !isPerimeterRevisit(packet)) {
                     bubble("This packet has already been forwarded!");
                     forwardPacketsDuplicateAvoid++;
                 }
+                // Check if the packet is a copy of a broadcast being assessed for suppression
+                else if (updateBroadcastAssessment(packet)) {
+                    bubble("Overheard a copy of a broadcast to forward!");
+                    forwardPacketsDuplicateAvoid++;
+                }
                 // Check if the packet is buffered to be forwarded
                 else if (isPacketToBeForwarded(packet)) {
                     bubble("This packet is already scheduled to be forwarded!");
@@ -2950,10 +3378,16 @@ void LoRaNodeApp::manageReceivedDataPacketToForward(cMessage *msg) {
 
                     dataPacket->setTtl(packet->getTtl() - 1);
                     if (packetsToForwardMaxVectorSize == 0 || LoRaPacketsToForward.size()<packetsToForwardMaxVectorSize) {
-                        LoRaPacketsToForward.push_back(*dataPacket);
-                        // Debug instrumentation: log enqueue of a forward packet (all flows)
-                        logPathHop(dataPacket, "ENQUEUE_FWD");
-                        newPacketToForward = true;
+                        // Broadcasts wait out a random assessment delay before they are queued
+                        if (isBroadcastSuppressible(packet)) {
+                            startBroadcastAssessment(packet, *dataPacket);
+                        }
+                        else {
+                            LoRaPacketsToForward.push_back(*dataPacket);
+                            // Debug instrumentation: log enqueue of a forward packet (all flows)
+                            logPathHop(dataPacket, "ENQUEUE_FWD");
+                            newPacketToForward = true;
+                        }
                     }
                     else {
                         forwardBufferFull++;
@@ -2963,58 +3397,61 @@ void LoRaNodeApp::manageReceivedDataPacketToForward(cMessage *msg) {
 
     }
 
+    if (newPacketToForward)
+        scheduleForwardPacket(packet);
+
     delete dataPacket;
+}
 
-    if (newPacketToForward) {
-        forwardPacketsDue = true;
+void LoRaNodeApp::scheduleForwardPacket(const LoRaAppPacket *packet) {
+    forwardPacketsDue = true;
 
-        // CRITICAL FIX: Update nextForwardPacketTransmissionTime to enable immediate forwarding
-        // Without this, relay nodes wait for timeToFirstForwardPacket (default 300s) before forwarding!
-        if (nextForwardPacketTransmissionTime > simTime()) {
-            nextForwardPacketTransmissionTime = simTime() + 0.1; // Allow forwarding very soon (100ms delay)
-        }
+    // CRITICAL FIX: Update nextForwardPacketTransmissionTime to enable immediate forwarding
+    // Without this, relay nodes wait for timeToFirstForwardPacket (default 300s) before forwarding!
+    if (nextForwardPacketTransmissionTime > simTime()) {
+        nextForwardPacketTransmissionTime = simTime() + 0.1; // Allow forwarding very soon (100ms delay)
+    }
 
-        // DEBUG: Log packet enqueue details
-        EV_WARN << "[FWD-DEBUG] Node " << nodeId << " ENQUEUED DATA packet at t=" << simTime()
-                << " src=" << packet->getSource() << " dst=" << packet->getDestination()
-                << " | forwardQueueSize=" << LoRaPacketsToForward.size()
-                << " nextFwdTime=" << nextForwardPacketTransmissionTime
-                << " selfScheduled=" << (selfPacket ? selfPacket->isScheduled() : false) << endl;
+    // DEBUG: Log packet enqueue details
+    EV_WARN << "[FWD-DEBUG] Node " << nodeId << " ENQUEUED DATA packet at t=" << simTime()
+            << " src=" << packet->getSource() << " dst=" << packet->getDestination()
+            << " | forwardQueueSize=" << LoRaPacketsToForward.size()
+            << " nextFwdTime=" << nextForwardPacketTransmissionTime
+            << " selfScheduled=" << (selfPacket ? selfPacket->isScheduled() : false) << endl;
 
-        // Recreate selfPacket if it was deleted by global convergence handler
-        if (!selfPacket) {
-            selfPacket = new cMessage("selfPacket");
-            selfPacket->setSchedulingPriority(-10);
-            EV_WARN << "[SELFPACKET-RECREATE] Node " << nodeId << " RECREATED selfPacket for DATA at t=" << simTime() << endl;
-        }
+    // Recreate selfPacket if it was deleted by global convergence handler
+    if (!selfPacket) {
+        selfPacket = new cMessage("selfPacket");
+        selfPacket->setSchedulingPriority(-10);
+        EV_WARN << "[SELFPACKET-RECREATE] Node " << nodeId << " RECREATED selfPacket for DATA at t=" << simTime() << endl;
+    }
 
-        // CRITICAL FIX: If selfPacket is scheduled too far in the future (e.g., 1M seconds after convergence),
-        // cancel and reschedule it earlier to process forward packets promptly
-        simtime_t nextScheduleTime = simTime() + 10*simTimeResolution;
-        if (enforceDutyCycle) {
-            nextScheduleTime = std::max(nextScheduleTime.dbl(), dutyCycleEnd.dbl());
-        }
-        if (! (nextScheduleTime > simTime()) ) {
-            nextScheduleTime = simTime() + 1;
-        }
+    // CRITICAL FIX: If selfPacket is scheduled too far in the future (e.g., 1M seconds after convergence),
+    // cancel and reschedule it earlier to process forward packets promptly
+    simtime_t nextScheduleTime = simTime() + 10*simTimeResolution;
+    if (enforceDutyCycle) {
+        nextScheduleTime = std::max(nextScheduleTime.dbl(), dutyCycleEnd.dbl());
+    }
+    if (! (nextScheduleTime > simTime()) ) {
+        nextScheduleTime = simTime() + 1;
+    }
 
-        if (selfPacket->isScheduled()) {
-            simtime_t scheduledTime = selfPacket->getArrivalTime();
-            if (scheduledTime > nextScheduleTime) {
-                EV_WARN << "[SELFPACKET-RESCHEDULE] Node " << nodeId << " CANCELING selfPacket scheduled for t="
-                        << scheduledTime << ", rescheduling for DATA at t=" << nextScheduleTime << endl;
-                cancelEvent(selfPacket);
-                scheduleAt(nextScheduleTime, selfPacket);
-            } else {
-                EV_WARN << "[SELFPACKET-SKIP] Node " << nodeId << " selfPacket already scheduled soon at t="
-                        << scheduledTime << " for DATA" << endl;
-            }
-        } else {
-            EV_WARN << "[SELFPACKET-SCHEDULE] Node " << nodeId << " scheduling selfPacket for DATA at t=" << nextScheduleTime << endl;
+    if (selfPacket->isScheduled()) {
+        simtime_t scheduledTime = selfPacket->getArrivalTime();
+        if (scheduledTime > nextScheduleTime) {
+            EV_WARN << "[SELFPACKET-RESCHEDULE] Node " << nodeId << " CANCELING selfPacket scheduled for t="
+                    << scheduledTime << ", rescheduling for DATA at t=" << nextScheduleTime << endl;
+            cancelEvent(selfPacket);
             scheduleAt(nextScheduleTime, selfPacket);
+        } else {
+            EV_WARN << "[SELFPACKET-SKIP] Node " << nodeId << " selfPacket already scheduled soon at t="
+                    << scheduledTime << " for DATA" << endl;
         }
-        forwardPacketsDue = true;
+    } else {
+        EV_WARN << "[SELFPACKET-SCHEDULE] Node " << nodeId << " scheduling selfPacket for DATA at t=" << nextScheduleTime << endl;
+        scheduleAt(nextScheduleTime, selfPacket);
     }
+    forwardPacketsDue = true;
 }
 
 void LoRaNodeApp::manageReceivedPacketForMe(cMessage *msg) {
@@ -3027,7 +3464,16 @@ void LoRaNodeApp::manageReceivedPacketForMe(cMessage *msg) {
     case DATA:
         // Log definitive delivery and emit a signal for statistics
         logDeliveredPacket(packet);
+        if (hopTrail)
+            logHopTrail(packet);
+        // Per-flow latency of the first copy of each packet
+        if (recordFlowLatency && flowDeliveredSequences[packet->getSource()].insert(packet->getDataInt()).second)
+            flowLatency[packet->getSource()].collect(simTime() - packet->getDepartureTime());
         emit(LoRa_AppPacketDelivered, (long)packet->getSource());
+        // Hop count as relays traversed, assuming the source used the same packetTTL
+        if (flowStatistics != nullptr)
+            flowStatistics->reportDelivered(packet->getSource(), nodeId, packet->getDataInt(),
+                    simTime() - packet->getDepartureTime(), packetTTL - packet->getTtl());
         
         // Generate ACK packet back to source using routing tables
         EV << "Destination received DATA packet from " << packet->getSource() << ", generating ACK" << endl;
@@ -3087,6 +3533,23 @@ bool LoRaNodeApp::handleOperationStage(LifecycleOperation *operation, int stage,
         IDoneCallback *doneCallback) {
     Enter_Method_Silent();
 
+    // Node operations started elsewhere (e.g. a ScenarioManager) fail or recover
+    // the application; the rest of the node handles its own stages
+    if (dynamic_cast<NodeCrashOperation *>(operation)) {
+        if ((NodeCrashOperation::Stage)stage == NodeCrashOperation::STAGE_CRASH)
+            performFailure(false);
+        return true;
+    }
+    else if (dynamic_cast<NodeShutdownOperation *>(operation)) {
+        if ((NodeShutdownOperation::Stage)stage == NodeShutdownOperation::STAGE_APPLICATION_LAYER)
+            performFailure(false);
+        return true;
+    }
+    else if (dynamic_cast<NodeStartOperation *>(operation)) {
+        if ((NodeStartOperation::Stage)stage == NodeStartOperation::STAGE_APPLICATION_LAYER)
+            performRecovery(false);
+        return true;
+    }
     throw cRuntimeError("Unsupported lifecycle operation '%s'",
             operation->getClassName());
     return true;
@@ -3102,9 +3565,12 @@ simtime_t LoRaNodeApp::sendDataPacket() {
     simtime_t txDuration = 0;
 
     // Send local data packets with a configurable ownDataPriority priority over packets to forward, if there is any
-    if (
-            (LoRaPacketsToSend.size() > 0 && bernoulli(ownDataPriority))
-            || (LoRaPacketsToSend.size() > 0 && LoRaPacketsToForward.size() == 0)) {
+    // (with fair forwarding, own and forwarded packets share the channel by deficit round robin)
+    bool sendOwnData = fairForwarding
+            ? LoRaPacketsToSend.size() > 0 && (LoRaPacketsToForward.size() == 0 || isOwnDataTurn())
+            : (LoRaPacketsToSend.size() > 0 && bernoulli(ownDataPriority))
+              || (LoRaPacketsToSend.size() > 0 && LoRaPacketsToForward.size() == 0);
+    if (sendOwnData) {
 
         bubble("Sending a local data packet!");
 
@@ -3132,6 +3598,8 @@ simtime_t LoRaNodeApp::sendDataPacket() {
         dataPacket->setName(fullName.c_str());
 
         LoRaPacketsToSend.erase(LoRaPacketsToSend.begin());
+        if (lazyDataPackets && LoRaPacketsToSend.empty())
+            generateNextDataPacket();
 
         transmit = true;
 
@@ -3139,6 +3607,7 @@ simtime_t LoRaNodeApp::sendDataPacket() {
         if (firstDataPacketTransmissionTime == 0)
             firstDataPacketTransmissionTime = simTime();
         lastDataPacketTransmissionTime = simTime();
+        updateDataDoneTracker();
     }
 
     // Forward other nodes' packets, if any
@@ -3186,12 +3655,25 @@ simtime_t LoRaNodeApp::sendDataPacket() {
                     dataPacket->getOptions().setAppACKReq(LoRaPacketsToForward.front().getOptions().getAppACKReq());
                     dataPacket->setByteLength(LoRaPacketsToForward.front().getByteLength());
                     dataPacket->setDepartureTime(LoRaPacketsToForward.front().getDepartureTime());
+                    dataPacket->setDestinationKnown(LoRaPacketsToForward.front().getDestinationKnown());
+                    dataPacket->setDestinationX(LoRaPacketsToForward.front().getDestinationX());
+                    dataPacket->setDestinationY(LoRaPacketsToForward.front().getDestinationY());
+                    dataPacket->setPerimeterMode(LoRaPacketsToForward.front().getPerimeterMode());
+                    dataPacket->setPerimeterEntryX(LoRaPacketsToForward.front().getPerimeterEntryX());
+                    dataPacket->setPerimeterEntryY(LoRaPacketsToForward.front().getPerimeterEntryY());
+                    dataPacket->setPerimeterFirstFrom(LoRaPacketsToForward.front().getPerimeterFirstFrom());
+                    dataPacket->setPerimeterFirstTo(LoRaPacketsToForward.front().getPerimeterFirstTo());
+                    dataPacket->setLastHop(LoRaPacketsToForward.front().getLastHop());
+                    dataPacket->setLastHopX(LoRaPacketsToForward.front().getLastHopX());
+                    dataPacket->setLastHopY(LoRaPacketsToForward.front().getLastHopY());
+                    dataPacket->setHopTrail(LoRaPacketsToForward.front().getHopTrail());
 
                     // Erase the first packet in the forwarding buffer
-                    LoRaPacketsToForward.erase(LoRaPacketsToForward.begin());
+                    LoRaPacketsToForward.pop_front();
+                    forgetBroadcastAssessment(dataPacket);
 
                     // Redundantly check that the packet has not been forwarded in the mean time, which should never occur
-                    if (!isPacketForwarded(dataPacket)) {
+                    if (!isPacketForwarded(dataPacket) || isPerimeterRevisit(dataPacket)) {
                         bubble("Forwarding packet!");
                         forwardedPackets++;
                         forwardedDataPackets++;
@@ -3287,37 +3769,70 @@ simtime_t LoRaNodeApp::sendDataPacket() {
                         broadcastForwardedPackets++;
                 }
                 break;
+            case GEOGRAPHIC_SINGLE_SF: {
+                int via = getGeographicNextHop(dataPacket);
+                if (via < 0) {
+                    delete cInfo;
+                    delete dataPacket;
+                    return 0;
+                }
+                dataPacket->setVia(via);
+                if (via == BROADCAST_ADDRESS) {
+                    if (localData)
+                        broadcastDataPackets++;
+                    else
+                        broadcastForwardedPackets++;
+                }
+                break;
+            }
         }
 
+        if (!localData)
+            aggregateForwardPackets(dataPacket, "TX_FWD");
+
         // Log hop decision for all flows
         logPathHop(dataPacket, localData ? "TX_SRC" : "TX_FWD");
+        if (flowStatistics != nullptr) {
+            if (localData)
+                flowStatistics->reportGenerated(nodeId, dataPacket->getDestination());
+            else
+                flowStatistics->reportForwarded(nodeId);
+        }
 
+        if (linkAdaptation && dataPacket->getVia() != BROADCAST_ADDRESS)
+            adaptToLink(cInfo, dataPacket->getVia());
+        int txSF = cInfo->getLoRaSF();
+        double txTP = cInfo->getLoRaTP();
         dataPacket->setControlInfo(cInfo);
 
         txDuration = calculateTransmissionDuration(dataPacket);
+        chargeTransmission(localData, dataPacket->getByteLength());
+        if (implicitAcks)
+            expectImplicitAck(dataPacket, txDuration);
 
-        allTxPacketsSFStats.collect(loRaSF);
+        allTxPacketsSFStats.collect(txSF);
         if (localData) {
-            owndataTxPacketsSFStats.collect(loRaSF);
+            owndataTxPacketsSFStats.collect(txSF);
         }
         else {
-            fwdTxPacketsSFStats.collect(loRaSF);
+            fwdTxPacketsSFStats.collect(txSF);
         }
 
 
+        stampLastHop(dataPacket);
         send(dataPacket, "appOut");
-        txSfVector.record(loRaSF);
-        txTpVector.record(loRaTP);
+        txSfVector.collect(txSF);
+        txTpVector.collect(txTP);
         //rxRssiVector.record(loRaTP);
 
-        emit(LoRa_AppPacketSent, loRaSF);
+        emit(LoRa_AppPacketSent, txSF);
     }
     else {
         delete dataPacket;
     }
 
     // Generate more packets if needed
-    if (sendPacketsContinuously && LoRaPacketsToSend.size() == 0) {
+    if (sendPacketsContinuously && trafficModel == nullptr && LoRaPacketsToSend.size() == 0) {
         generateDataPackets();
     }
 
@@ -3374,12 +3889,25 @@ simtime_t LoRaNodeApp::sendForwardPacket() {
                     forwardPacket->getOptions().setAppACKReq(LoRaPacketsToForward.front().getOptions().getAppACKReq());
                     forwardPacket->setByteLength(LoRaPacketsToForward.front().getByteLength());
                     forwardPacket->setDepartureTime(LoRaPacketsToForward.front().getDepartureTime());
+                    forwardPacket->setDestinationKnown(LoRaPacketsToForward.front().getDestinationKnown());
+                    forwardPacket->setDestinationX(LoRaPacketsToForward.front().getDestinationX());
+                    forwardPacket->setDestinationY(LoRaPacketsToForward.front().getDestinationY());
+                    forwardPacket->setPerimeterMode(LoRaPacketsToForward.front().getPerimeterMode());
+                    forwardPacket->setPerimeterEntryX(LoRaPacketsToForward.front().getPerimeterEntryX());
+                    forwardPacket->setPerimeterEntryY(LoRaPacketsToForward.front().getPerimeterEntryY());
+                    forwardPacket->setPerimeterFirstFrom(LoRaPacketsToForward.front().getPerimeterFirstFrom());
+                    forwardPacket->setPerimeterFirstTo(LoRaPacketsToForward.front().getPerimeterFirstTo());
+                    forwardPacket->setLastHop(LoRaPacketsToForward.front().getLastHop());
+                    forwardPacket->setLastHopX(LoRaPacketsToForward.front().getLastHopX());
+                    forwardPacket->setLastHopY(LoRaPacketsToForward.front().getLastHopY());
+                    forwardPacket->setHopTrail(LoRaPacketsToForward.front().getHopTrail());
 
                     // Erase the first packet in the forwarding buffer
-                    LoRaPacketsToForward.erase(LoRaPacketsToForward.begin());
+                    LoRaPacketsToForward.pop_front();
+                    forgetBroadcastAssessment(forwardPacket);
 
                     // Redundantly check that the packet has not been forwarded in the mean time, which should never occur
-                    if (!isPacketForwarded(forwardPacket)) {
+                    if (!isPacketForwarded(forwardPacket) || isPerimeterRevisit(forwardPacket)) {
                         bubble("Forwarding packet!");
                         forwardedPackets++;
                         if (forwardPacket->getMsgType() == DATA) {
@@ -3486,27 +4014,51 @@ simtime_t LoRaNodeApp::sendForwardPacket() {
                     broadcastForwardedPackets++;
                 }
                 break;
+            case GEOGRAPHIC_SINGLE_SF: {
+                int via = getGeographicNextHop(forwardPacket);
+                if (via < 0) {
+                    delete cInfo;
+                    delete forwardPacket;
+                    return 0;
+                }
+                forwardPacket->setVia(via);
+                if (via == BROADCAST_ADDRESS)
+                    broadcastForwardedPackets++;
+                break;
+            }
         }
 
+        aggregateForwardPackets(forwardPacket, "TX_FWD_DATA");
+
         // Log all forwarded transmissions with specific packet type
         if (forwardPacket->getMsgType() == ACK) {
             logPathHop(forwardPacket, "TX_FWD_ACK");
         } else {
             logPathHop(forwardPacket, "TX_FWD_DATA");
         }
+        if (flowStatistics != nullptr)
+            flowStatistics->reportForwarded(nodeId);
 
+        if (linkAdaptation && forwardPacket->getVia() != BROADCAST_ADDRESS)
+            adaptToLink(cInfo, forwardPacket->getVia());
+        int txSF = cInfo->getLoRaSF();
+        double txTP = cInfo->getLoRaTP();
         forwardPacket->setControlInfo(cInfo);
 
         txDuration = calculateTransmissionDuration(forwardPacket);
+        chargeTransmission(false, forwardPacket->getByteLength());
+        if (implicitAcks)
+            expectImplicitAck(forwardPacket, txDuration);
 
-        allTxPacketsSFStats.collect(loRaSF);
-        fwdTxPacketsSFStats.collect(loRaSF);
+        allTxPacketsSFStats.collect(txSF);
+        fwdTxPacketsSFStats.collect(txSF);
 
+        stampLastHop(forwardPacket);
         send(forwardPacket, "appOut");
-        txSfVector.record(loRaSF);
-        txTpVector.record(loRaTP);
+        txSfVector.collect(txSF);
+        txTpVector.collect(txTP);
         //rxRssiVector.record(loRaTP);
-        emit(LoRa_AppPacketSent, loRaSF);
+        emit(LoRa_AppPacketSent, txSF);
     }
     else {
         delete forwardPacket;
@@ -3549,6 +4101,7 @@ simtime_t LoRaNodeApp::sendRoutingPacket() {
 
         case FLOODING_BROADCAST_SINGLE_SF:
         case SMART_BROADCAST_SINGLE_SF:
+        case GEOGRAPHIC_SINGLE_SF:
             break;
 
         case HOP_COUNT_SINGLE_SF:
@@ -3652,8 +4205,8 @@ simtime_t LoRaNodeApp::sendRoutingPacket() {
         routingPacket->setByteLength(routingPacketMaxSize);
         routingPacket->setDepartureTime(simTime());
 
-        txSfVector.record(loRaSF);
-        txTpVector.record(loRaTP);
+        txSfVector.collect(loRaSF);
+        txTpVector.collect(loRaTP);
         //rxRssiVector.record(loRaTP);
 
         txDuration = calculateTransmissionDuration(routingPacket);
@@ -3661,6 +4214,7 @@ simtime_t LoRaNodeApp::sendRoutingPacket() {
         allTxPacketsSFStats.collect(loRaSF);
         routingTxPacketsSFStats.collect(loRaSF);
 
+        stampLastHop(routingPacket);
         send(routingPacket, "appOut");
         bubble("Sending routing packet");
         emit(LoRa_AppPacketSent, loRaSF);
@@ -3715,7 +4269,7 @@ simtime_t LoRaNodeApp::sendDSDVRoutingPacket(bool fullDump) {
                 LoRaRoute route;
                 route.setId(rt.id);
                 route.setPriMetric(rt.metric);
-                route.setSeqNum(rt.seqNum);
+                route.setSeqNum(getRouteSeqNum(rt.id));
                 route.setFlags(rt.isValid ? 0 : 1);
                 routesToAdvertise.push_back(route);
             }
@@ -3738,7 +4292,7 @@ simtime_t LoRaNodeApp::sendDSDVRoutingPacket(bool fullDump) {
                 LoRaRoute route;
                 route.setId(singleMetricRoutingTable[idx].id);
                 route.setPriMetric(singleMetricRoutingTable[idx].metric);
-                route.setSeqNum(singleMetricRoutingTable[idx].seqNum);
+                route.setSeqNum(getRouteSeqNum(destId));
                 route.setFlags(singleMetricRoutingTable[idx].isValid ? 0 : 1);
                 routesToAdvertise.push_back(route);
             }
@@ -3812,14 +4366,15 @@ simtime_t LoRaNodeApp::sendDSDVRoutingPacket(bool fullDump) {
     // Record stats
     sentPackets++;
     sentRoutingPackets++;
-    txSfVector.record(loRaSF);
-    txTpVector.record(loRaTP);
+    txSfVector.collect(loRaSF);
+    txTpVector.collect(loRaTP);
     allTxPacketsSFStats.collect(loRaSF);
     routingTxPacketsSFStats.collect(loRaSF);
 
     // Calculate TX duration and send
     simtime_t txDuration = calculateTransmissionDuration(routingPacket);
 
+    stampLastHop(routingPacket);
     send(routingPacket, "appOut");
     emit(LoRa_AppPacketSent, loRaSF);
 
@@ -3900,6 +4455,18 @@ simtime_t LoRaNodeApp::sendAckPacket(int destinationNode, int originalDataSeq) {
                 EV << "No route to " << destinationNode << " for ACK, using broadcast fallback" << endl;
             }
             break;
+        case GEOGRAPHIC_SINGLE_SF: {
+            int via = getGeographicNextHop(ackPacket);
+            if (via < 0) {
+                delete cInfo;
+                delete ackPacket;
+                return 0;
+            }
+            ackPacket->setVia(via);
+            if (via == BROADCAST_ADDRESS)
+                broadcastDataPackets++;
+            break;
+        }
         default:
             ackPacket->setVia(BROADCAST_ADDRESS);
             break;
@@ -3917,6 +4484,7 @@ simtime_t LoRaNodeApp::sendAckPacket(int destinationNode, int originalDataSeq) {
     allTxPacketsSFStats.collect(loRaSF);
 
     // Send the ACK packet
+    stampLastHop(ackPacket);
     send(ackPacket, "appOut");
     
     EV << "Sent ACK from " << nodeId << " to " << destinationNode << " for data seq " << originalDataSeq << endl;
@@ -3933,7 +4501,16 @@ void LoRaNodeApp::generateDataPackets() {
     if (!onlyNode0SendsPackets || originalNodeIndex == 0) {
         EV << "DEBUG: Packet generation condition met for node " << nodeId << endl;
         std::cout << "DEBUG: Packet generation condition met for node " << nodeId << std::endl;
-        
+
+        if (lazyDataPackets) {
+            initDataCursor();
+            dataCursorNext = 0;
+            dataCursorTotal = (long)dataCursorDestinations * numberOfPacketsPerDestination;
+            dataCursorStartTime = simTime();
+            generateNextDataPacket();
+            return;
+        }
+
         std::vector<int> destinations = { };
         // If configured, force this node to send only to a specific destination (supports any node ID, including 1000/1001)
         bool forceSingleDestination = par("forceSingleDestination");
@@ -3970,34 +4547,7 @@ void LoRaNodeApp::generateDataPackets() {
 
         for (int k = 0; k < numberOfPacketsPerDestination; k++) {
             for (int j = 0; j < destinations.size(); j++) {
-                LoRaAppPacket *dataPacket = new LoRaAppPacket("DataPacket");
-
-                dataPacket->setMsgType(DATA);
-                // Assign a unique, monotonically increasing sequence per packet
-                dataPacket->setDataInt(currDataInt++);
-                dataPacket->setSource(nodeId);
-                dataPacket->setVia(nodeId);
-                dataPacket->setDestination(destinations[j]);
-                dataPacket->getOptions().setAppACKReq(requestACKfromApp);
-                dataPacket->setByteLength(dataPacketSize);
-                dataPacket->setDepartureTime(simTime());
-
-                EV << "DEBUG: Created packet from " << nodeId << " to " << destinations[j] << " (seq=" << dataPacket->getDataInt() << ")" << endl;
-                std::cout << "DEBUG: Created packet from " << nodeId << " to " << destinations[j] << " (seq=" << dataPacket->getDataInt() << ")" << std::endl;
-
-                switch (routingMetric) {
-    //            case 0:
-    //                dataPacket->setTtl(1);
-    //                break;
-                default:
-                    dataPacket->setTtl(packetTTL);
-                    break;
-                }
-
-                LoRaPacketsToSend.push_back(*dataPacket);
-                EV << "DEBUG: Added packet to send queue, queue size now: " << LoRaPacketsToSend.size() << endl;
-                std::cout << "DEBUG: Added packet to send queue, queue size now: " << LoRaPacketsToSend.size() << std::endl;
-                delete dataPacket;
+                queueDataPacket(destinations[j]);
             }
         }
     } else {
@@ -4006,6 +4556,156 @@ void LoRaNodeApp::generateDataPackets() {
     }
 }
 
+void LoRaNodeApp::initDataCursor() {
+    dataCursorForcedDestination = -1;
+    // If configured, force this node to send only to a specific destination (supports any node ID, including 1000/1001)
+    bool forceSingleDestination = par("forceSingleDestination");
+    int forcedDestinationId = par("forcedDestinationId");
+    if (forceSingleDestination && forcedDestinationId >= 0 && forcedDestinationId != nodeId) {
+        dataCursorForcedDestination = forcedDestinationId;
+        dataCursorDestinations = 1;
+        EV_DEBUG << "Using forced destination " << forcedDestinationId << " for node " << nodeId << endl;
+        return;
+    }
+    if (numberOfDestinationsPerNode == 0 )
+        numberOfDestinationsPerNode = numberOfNodes-1;
+
+    // Destinations are the first dataCursorDestinations entries of a seeded pseudo-random
+    // permutation of the other nodes: distinct, O(1) state, no rejection sampling, and unlike
+    // an arithmetic progression not correlated with the node indices (i.e. grid positions)
+    bool selfIsCandidate = nodeId >= 0 && nodeId < numberOfNodes;
+    dataCursorCandidates = numberOfNodes - (selfIsCandidate ? 1 : 0);
+    dataCursorDestinations = std::max(0, std::min(numberOfDestinationsPerNode, numberOfNodes - 1));
+    dataCursorHalfBits = 1;
+    while ((1LL << (2 * dataCursorHalfBits)) < dataCursorCandidates)
+        dataCursorHalfBits++;
+    for (auto& key : dataCursorKeys)
+        key = intuniform(0, INT_MAX);
+}
+
+int LoRaNodeApp::permuteDataCursorIndex(int index) const {
+    // Feistel network over 2 * dataCursorHalfBits bits (a bijection for any round function),
+    // walking the cycle until the value falls back into [0, dataCursorCandidates)
+    uint32_t mask = (1u << dataCursorHalfBits) - 1;
+    uint32_t value = index;
+    do {
+        uint32_t left = value >> dataCursorHalfBits;
+        uint32_t right = value & mask;
+        for (uint32_t key : dataCursorKeys) {
+            uint32_t mix = (right ^ key) * 0x9E3779B1u;
+            mix ^= mix >> 15;
+            uint32_t next = left ^ (mix & mask);
+            left = right;
+            right = next;
+        }
+        value = (left << dataCursorHalfBits) | right;
+    } while (value >= (uint32_t)dataCursorCandidates);
+    return (int)value;
+}
+
+void LoRaNodeApp::startTrafficModel() {
+    trafficWheel = getModuleFromPar<LoRaTrafficWheel>(par("trafficWheelModule"), this);
+    trafficMaxPackets = par("trafficMaxPackets");
+    initDataCursor();
+    if (trafficModel->reportsAlarms()) {
+        Coord position;
+        if (auto mobility = dynamic_cast<inet::IMobility *>(getContainingNode(this)->getSubmodule("mobility")))
+            position = mobility->getCurrentPosition();
+        trafficWheel->registerAlarmClient(this, position);
+    }
+    simtime_t firstArrivalTime = trafficModel->getFirstArrivalTime(simTime() + par("trafficStartTime"));
+    if (firstArrivalTime >= 0 && trafficMaxPackets != 0)
+        trafficWheel->scheduleArrival(this, firstArrivalTime);
+}
+
+void LoRaNodeApp::handleTrafficArrival(int kind) {
+    Enter_Method_Silent();
+
+    trafficArrivals++;
+    if (kind == LoRaTrafficWheel::ALARM_REPORT)
+        trafficAlarmReports++;
+    // The arrival process keeps running while the node is failed, so it resumes on recovery
+    else if (trafficMaxPackets < 0 || trafficArrivals - trafficAlarmReports < trafficMaxPackets)
+        trafficWheel->scheduleArrival(this, trafficModel->getNextArrivalTime(simTime()));
+
+    if (failed || dataCursorDestinations == 0)
+        return;
+    queueDataPacket(getDataCursorDestination(trafficPacketIndex++));
+    dataPacketsDue = true;
+
+    // A parked transmission is sent when the MAC reports ready
+    if (waitForMacReady && waitingForMacReady)
+        return;
+    if (!selfPacket) {
+        selfPacket = new cMessage("selfPacket");
+        selfPacket->setSchedulingPriority(-10);
+    }
+    simtime_t nextScheduleTime = std::max(simTime(), nextDataPacketTransmissionTime) + 10*simTimeResolution;
+    if (enforceDutyCycle) {
+        nextScheduleTime = std::max(nextScheduleTime, dutyCycleEnd);
+    }
+    if (selfPacket->isScheduled()) {
+        if (selfPacket->getArrivalTime() <= nextScheduleTime)
+            return;
+        cancelEvent(selfPacket);
+    }
+    scheduleAt(nextScheduleTime, selfPacket);
+}
+
+void LoRaNodeApp::queueDataPacket(int destination) {
+    LoRaAppPacket *dataPacket = new LoRaAppPacket("DataPacket");
+
+    dataPacket->setMsgType(DATA);
+    // Assign a unique, monotonically increasing sequence per packet
+    dataPacket->setDataInt(currDataInt++);
+    dataPacket->setSource(nodeId);
+    dataPacket->setVia(nodeId);
+    dataPacket->setDestination(destination);
+    dataPacket->getOptions().setAppACKReq(requestACKfromApp);
+    dataPacket->setByteLength(dataPacketSize);
+    dataPacket->setDepartureTime(simTime());
+
+    EV_DEBUG << "Created packet from " << nodeId << " to " << destination << " (seq=" << dataPacket->getDataInt() << ")" << endl;
+
+    switch (routingMetric) {
+//            case 0:
+//                dataPacket->setTtl(1);
+//                break;
+    default:
+        dataPacket->setTtl(packetTTL);
+        break;
+    }
+
+    LoRaPacketsToSend.push_back(*dataPacket);
+    EV_DEBUG << "Added packet to send queue, queue size now: " << LoRaPacketsToSend.size() << endl;
+    delete dataPacket;
+}
+
+void LoRaNodeApp::generateNextDataPacket() {
+    // Same order as the eager generator: every destination once, numberOfPacketsPerDestination rounds
+    if (dataCursorNext < dataCursorTotal) {
+        queueDataPacket(getDataCursorDestination(dataCursorNext++));
+        LoRaPacketsToSend.back().setDepartureTime(dataCursorStartTime);
+    }
+}
+
+int LoRaNodeApp::getDataCursorDestination(long packetIndex) const {
+    if (dataCursorForcedDestination >= 0)
+        return dataCursorForcedDestination;
+    int destination = permuteDataCursorIndex((int)(packetIndex % dataCursorDestinations));
+    // Candidates are 0..numberOfNodes-1 without this node
+    if (nodeId >= 0 && destination >= nodeId)
+        destination++;
+    return destination;
+}
+
+long LoRaNodeApp::getPendingDataPacketCount() const {
+    long pending = LoRaPacketsToSend.size();
+    if (lazyDataPackets)
+        pending += dataCursorTotal - dataCursorNext;
+    return pending;
+}
+
 void LoRaNodeApp::increaseSFIfPossible() {
     if (loRaSF < 12) {
         // char text[32];
@@ -4102,18 +4802,524 @@ bool LoRaNodeApp::isPacketForwarded(cMessage *msg) {
 
 bool LoRaNodeApp::isPacketToBeForwarded(cMessage *msg) {
     LoRaAppPacket *packet = check_and_cast<LoRaAppPacket *>(msg);
+    return LoRaPacketsToForward.find(*packet) != nullptr;
+}
 
-    for (std::vector<LoRaAppPacket>::iterator lbptr =
-            LoRaPacketsToForward.begin(); lbptr < LoRaPacketsToForward.end();
-            lbptr++) {
-        if (packet->getMsgType() == lbptr->getMsgType()
-                && packet->getDataInt() == lbptr->getDataInt()
-                && packet->getSource() == lbptr->getSource()
-                && packet->getDestination() == lbptr->getDestination()) {
-            return true;
+LoRaNodeApp::broadcastKey LoRaNodeApp::getBroadcastKey(const LoRaAppPacket *packet) {
+    return std::make_tuple(packet->getMsgType(), packet->getDataInt(), packet->getSource(), packet->getDestination());
+}
+
+bool LoRaNodeApp::isBroadcastSuppressible(const LoRaAppPacket *packet) const {
+    return broadcastSuppression != SUPPRESSION_NONE
+            && (routingMetric == FLOODING_BROADCAST_SINGLE_SF || routingMetric == SMART_BROADCAST_SINGLE_SF)
+            && packet->getVia() == BROADCAST_ADDRESS;
+}
+
+void LoRaNodeApp::startBroadcastAssessment(const LoRaAppPacket *received, const LoRaAppPacket &toForward) {
+    broadcastAssessment &assessment = broadcastAssessments[getBroadcastKey(received)];
+    assessment.packet = toForward;
+    assessment.deadline = simTime() + uniform(0, suppressionAssessmentDelay);
+    // The copy that made the packet known counts like any later one
+    assessment.copies = 1;
+    assessment.maxRssi = received->getOptions().getRSSI();
+    assessment.coveredNodes.push_back(received->getSource());
+    if (received->getLastHop() >= 0 && received->getLastHop() != received->getSource())
+        assessment.coveredNodes.push_back(received->getLastHop());
+    scheduleBroadcastAssessmentTimer();
+}
+
+bool LoRaNodeApp::updateBroadcastAssessment(const LoRaAppPacket *copy) {
+    auto it = broadcastAssessments.find(getBroadcastKey(copy));
+    if (it == broadcastAssessments.end())
+        return false;
+    broadcastAssessment &assessment = it->second;
+    assessment.copies++;
+    assessment.maxRssi = std::max(assessment.maxRssi, copy->getOptions().getRSSI());
+    if (copy->getLastHop() >= 0
+            && std::find(assessment.coveredNodes.begin(), assessment.coveredNodes.end(), copy->getLastHop()) == assessment.coveredNodes.end())
+        assessment.coveredNodes.push_back(copy->getLastHop());
+
+    // Packets still assessing are decided when the delay ends; queued ones are canceled right away
+    if (assessment.queued && isBroadcastRedundant(assessment)) {
+        if (LoRaPacketsToForward.erase(assessment.packet)) {
+            queuedBroadcastsCanceled++;
+            // Remember it as handled so that later copies are not forwarded either
+            LoRaPacketsForwarded.push_back(assessment.packet);
+            if (LoRaPacketsForwarded.size() > forwardedPacketVectorSize)
+                LoRaPacketsForwarded.erase(LoRaPacketsForwarded.begin());
         }
+        broadcastAssessments.erase(it);
     }
-    return false;
+    return true;
+}
+
+bool LoRaNodeApp::isBroadcastRedundant(const broadcastAssessment &assessment) const {
+    switch (broadcastSuppression) {
+        case SUPPRESSION_COUNTER:
+            return assessment.copies >= suppressionCounterThreshold;
+        case SUPPRESSION_DISTANCE:
+            return assessment.maxRssi >= suppressionRssiThreshold;
+        case SUPPRESSION_COVERAGE: {
+            // Without known neighbours there is nothing to prove the rebroadcast useless
+            bool anyNeighbour = false;
+            for (const auto &neighbour : heardNeighbours) {
+                if (simTime() - neighbour.second > suppressionNeighbourTimeout)
+                    continue;
+                anyNeighbour = true;
+                if (std::find(assessment.coveredNodes.begin(), assessment.coveredNodes.end(), neighbour.first) == assessment.coveredNodes.end())
+                    return false;
+            }
+            return anyNeighbour;
+        }
+        default:
+            return false;
+    }
+}
+
+void LoRaNodeApp::releaseAssessedBroadcasts() {
+    bool released = false;
+    const LoRaAppPacket *lastReleased = nullptr;
+    for (auto it = broadcastAssessments.begin(); it != broadcastAssessments.end(); ) {
+        broadcastAssessment &assessment = it->second;
+        if (assessment.queued || assessment.deadline > simTime()) {
+            it++;
+            continue;
+        }
+        if (isBroadcastRedundant(assessment)) {
+            bubble("Broadcast suppressed!");
+            broadcastsSuppressed++;
+            LoRaPacketsForwarded.push_back(assessment.packet);
+            if (LoRaPacketsForwarded.size() > forwardedPacketVectorSize)
+                LoRaPacketsForwarded.erase(LoRaPacketsForwarded.begin());
+            it = broadcastAssessments.erase(it);
+        }
+        else if (packetsToForwardMaxVectorSize != 0 && LoRaPacketsToForward.size() >= packetsToForwardMaxVectorSize) {
+            forwardBufferFull++;
+            it = broadcastAssessments.erase(it);
+        }
+        else {
+            assessment.queued = true;
+            LoRaPacketsToForward.push_back(assessment.packet);
+            logPathHop(&assessment.packet, "ENQUEUE_FWD");
+            lastReleased = &assessment.packet;
+            released = true;
+            it++;
+        }
+    }
+    if (released)
+        scheduleForwardPacket(lastReleased);
+    scheduleBroadcastAssessmentTimer();
+}
+
+void LoRaNodeApp::scheduleBroadcastAssessmentTimer() {
+    simtime_t next = SIMTIME_MAX;
+    for (const auto &entry : broadcastAssessments)
+        if (!entry.second.queued)
+            next = std::min(next, entry.second.deadline);
+    if (broadcastAssessmentTimer->isScheduled()) {
+        if (broadcastAssessmentTimer->getArrivalTime() == next)
+            return;
+        cancelEvent(broadcastAssessmentTimer);
+    }
+    if (next != SIMTIME_MAX)
+        scheduleAt(next, broadcastAssessmentTimer);
+}
+
+void LoRaNodeApp::forgetBroadcastAssessment(const LoRaAppPacket *packet) {
+    if (!broadcastAssessments.empty())
+        broadcastAssessments.erase(getBroadcastKey(packet));
+}
+
+Coord LoRaNodeApp::getOwnPosition() const {
+    Coord position = hostMobility != nullptr ? hostMobility->getCurrentPosition() : Coord::ZERO;
+    position.z = 0;
+    return position;
+}
+
+bool LoRaNodeApp::getNodePosition(int id, Coord &position) const {
+    // Location service: every node publishes its mobility module at initialization
+    auto it = geoLocationModules.find(id);
+    if (it == geoLocationModules.end())
+        return false;
+    IMobility *mobility = dynamic_cast<IMobility *>(getSimulation()->getModule(it->second));
+    if (mobility == nullptr)
+        return false;
+    position = mobility->getCurrentPosition();
+    position.z = 0;
+    return true;
+}
+
+void LoRaNodeApp::stampLastHop(LoRaAppPacket *packet) {
+    Coord position = getOwnPosition();
+    packet->setLastHop(nodeId);
+    packet->setLastHopX(position.x);
+    packet->setLastHopY(position.y);
+    if (hopTrail && packet->getMsgType() == DATA) {
+        appendHopTrail(packet->getHopTrail());
+        for (unsigned int i = 0; i < packet->getAggregatedArraySize(); i++)
+            appendHopTrail(packet->getAggregated(i).getHopTrail());
+    }
+}
+
+void LoRaNodeApp::appendHopTrail(LoRaHopTrail &trail) const {
+    int length = trail.getLength();
+    if (length < (int)trail.getNodeArraySize()) {
+        trail.setNode(length, nodeId);
+        trail.setTime(length, simTime());
+    }
+    trail.setLength(length + 1);
+}
+
+bool LoRaNodeApp::isPerimeterRevisit(const LoRaAppPacket *packet) const {
+    // Walking around a face may legitimately pass through a node twice
+    return routingMetric == GEOGRAPHIC_SINGLE_SF && packet->getPerimeterMode();
+}
+
+int LoRaNodeApp::getGeographicNextHop(LoRaAppPacket *packet) {
+    Coord self = getOwnPosition();
+
+    // The source stamps the destination position; relays use the one carried by the packet, or look
+    // it up themselves when nobody upstream could, and keep flooding while it stays unknown
+    if (packet->getSource() == nodeId || !packet->getDestinationKnown()) {
+        Coord destination;
+        if (!getNodePosition(packet->getDestination(), destination)) {
+            EV_WARN << "[GEO] Node " << nodeId << ": position of " << packet->getDestination() << " unknown, broadcasting" << endl;
+            geoFallbackBroadcasts++;
+            return BROADCAST_ADDRESS;
+        }
+        packet->setDestinationKnown(true);
+        packet->setDestinationX(destination.x);
+        packet->setDestinationY(destination.y);
+        packet->setPerimeterMode(false);
+    }
+    Coord destination(packet->getDestinationX(), packet->getDestinationY(), 0);
+
+    // Until neighbours have been overheard there is nobody to unicast to
+    geoNeighbours.purge(simTime(), geoNeighbourTimeout);
+    if (geoNeighbours.isEmpty()) {
+        geoFallbackBroadcasts++;
+        return BROADCAST_ADDRESS;
+    }
+
+    // Back to greedy once closer to the destination than where perimeter mode started
+    if (packet->getPerimeterMode()) {
+        Coord entry(packet->getPerimeterEntryX(), packet->getPerimeterEntryY(), 0);
+        if (self.distance(destination) < entry.distance(destination))
+            packet->setPerimeterMode(false);
+    }
+
+    if (!packet->getPerimeterMode()) {
+        int nextHop = geoNeighbours.findGreedyNextHop(self, destination);
+        if (nextHop >= 0) {
+            geoGreedyHops++;
+            return nextHop;
+        }
+        // Local maximum: walk the face crossed by the line towards the destination
+        nextHop = geoNeighbours.findPerimeterNextHop(self, destination);
+        packet->setPerimeterMode(true);
+        packet->setPerimeterEntryX(self.x);
+        packet->setPerimeterEntryY(self.y);
+        packet->setPerimeterFirstFrom(nodeId);
+        packet->setPerimeterFirstTo(nextHop);
+        geoPerimeterHops++;
+        return nextHop;
+    }
+
+    Coord previous = packet->getLastHop() >= 0 ? Coord(packet->getLastHopX(), packet->getLastHopY(), 0) : destination;
+    int nextHop = geoNeighbours.findPerimeterNextHop(self, previous);
+    // About to take the first perimeter edge again: the face does not lead closer to the destination
+    if (nodeId == packet->getPerimeterFirstFrom() && nextHop == packet->getPerimeterFirstTo()) {
+        EV_WARN << "[GEO] Node " << nodeId << ": destination " << packet->getDestination()
+                << " unreachable around the perimeter, dropping (seq=" << packet->getDataInt() << ")" << endl;
+        geoPerimeterDrops++;
+        return -1;
+    }
+    geoPerimeterHops++;
+    return nextHop;
+}
+
+bool LoRaNodeApp::isOwnDataTurn() {
+    // Deficit round robin between own and forwarded packets: a class keeps the turn while its
+    // credit covers its head packet, and gets forwardQuantum more bytes each time its turn comes
+    while (true) {
+        long &deficit = ownDataTurn ? ownDataDeficit : forwardDeficit;
+        if (!drrTurnStarted) {
+            deficit += drrQuantum;
+            drrTurnStarted = true;
+        }
+        long headBytes = ownDataTurn ? LoRaPacketsToSend.front().getByteLength() : LoRaPacketsToForward.front().getByteLength();
+        if (headBytes <= deficit)
+            return ownDataTurn;
+        ownDataTurn = !ownDataTurn;
+        drrTurnStarted = false;
+    }
+}
+
+void LoRaNodeApp::chargeTransmission(bool localData, long bytes) {
+    if (!fairForwarding)
+        return;
+    (localData ? ownDataDeficit : forwardDeficit) -= bytes;
+    // Credit only counts while both classes compete for the channel
+    if (LoRaPacketsToSend.empty() || LoRaPacketsToForward.empty()) {
+        ownDataDeficit = forwardDeficit = 0;
+        drrTurnStarted = false;
+    }
+}
+
+void LoRaNodeApp::adaptToLink(LoRaMacControlInfo *cInfo, int nextHop) {
+    // Dual-metric routes already chose the SF for this next hop
+    if (routingMetric == TIME_ON_AIR_HC_CAD_SF || routingMetric == TIME_ON_AIR_SF_CAD_SF)
+        return;
+    links.purge(simTime(), linkTimeout);
+    int sf;
+    double tp;
+    int minSF = loRaCAD ? minLoRaSF : loRaSF;
+    double sensitivityOffset = loRaCAD ? loRaCADatt : 0;
+    if (!links.choose(nextHop, minSF, loRaSF, minLoRaTP, loRaTP, loRaBW.get(), linkAdaptationMargin, sensitivityOffset, sf, tp))
+        return;
+    cInfo->setLoRaSF(sf);
+    cInfo->setLoRaTP(tp);
+    linkAdaptedFrames++;
+    linkAdaptationSFSaved += loRaSF - sf;
+    linkAdaptationTPSaved += loRaTP - tp;
+}
+
+void LoRaNodeApp::expectImplicitAck(const LoRaAppPacket *packet, simtime_t txDuration) {
+    int nextHop = packet->getVia();
+    for (int i = -1; i < (int)packet->getAggregatedArraySize(); i++) {
+        LoRaAppPacket sent(*packet);
+        if (i >= 0)
+            setAggregatedPacket(&sent, packet->getAggregated(i));
+        else {
+            sent.setByteLength(packet->getByteLength() - getAggregatedBytes(packet));
+            sent.setAggregatedArraySize(0);
+        }
+        if (sent.getMsgType() != DATA)
+            continue;
+
+        broadcastKey key = getBroadcastKey(&sent);
+        auto entry = std::find_if(hopAcks.begin(), hopAcks.end(), [&](const hopAckEntry &pending) {
+            return getBroadcastKey(&pending.packet) == key;
+        });
+        // Broadcasts and packets handed to their destination are not forwarded any further
+        if (nextHop == BROADCAST_ADDRESS || nextHop == sent.getDestination()) {
+            if (entry != hopAcks.end())
+                hopAcks.erase(entry);
+            continue;
+        }
+        if (entry == hopAcks.end()) {
+            hopAcks.emplace_back();
+            entry = hopAcks.end() - 1;
+        }
+        entry->packet = sent;
+        entry->nextHop = nextHop;
+        entry->deadline = simTime() + txDuration + implicitAckTimeout * (1 << entry->retries);
+    }
+    scheduleHopAckTimer();
+}
+
+void LoRaNodeApp::acknowledgeImplicitly(const LoRaAppPacket *packet) {
+    if (packet->getLastHop() < 0)
+        return;
+    broadcastKey key = getBroadcastKey(packet);
+    for (auto entry = hopAcks.begin(); entry != hopAcks.end(); entry++) {
+        if (entry->nextHop == packet->getLastHop() && getBroadcastKey(&entry->packet) == key) {
+            hopAcks.erase(entry);
+            implicitAcksHeard++;
+            scheduleHopAckTimer();
+            return;
+        }
+    }
+}
+
+void LoRaNodeApp::retransmitUnacknowledged() {
+    LoRaAppPacket retransmitted;
+    bool retransmit = false;
+    for (auto entry = hopAcks.begin(); entry != hopAcks.end(); ) {
+        if (entry->deadline > simTime()) {
+            entry++;
+        }
+        // Still waiting in the forward queue (e.g. duty cycle): the previous copy is not late yet
+        else if (LoRaPacketsToForward.find(entry->packet) != nullptr) {
+            entry->deadline = simTime() + implicitAckTimeout * (1 << entry->retries);
+            entry++;
+        }
+        else if (entry->retries >= implicitAckMaxRetries) {
+            EV_WARN << "[HOP-ACK] Node " << nodeId << ": " << entry->nextHop << " never forwarded src=" << entry->packet.getSource()
+                    << " dst=" << entry->packet.getDestination() << " seq=" << entry->packet.getDataInt() << ", giving up" << endl;
+            hopRetransmissionFailures++;
+            entry = hopAcks.erase(entry);
+        }
+        else if (packetsToForwardMaxVectorSize > 0 && LoRaPacketsToForward.size() >= (size_t)packetsToForwardMaxVectorSize) {
+            forwardBufferFull++;
+            hopRetransmissionFailures++;
+            entry = hopAcks.erase(entry);
+        }
+        else {
+            // Sent again from the forward queue; expectImplicitAck() keeps the retry count
+            entry->retries++;
+            entry->deadline = simTime() + implicitAckTimeout * (1 << entry->retries);
+            forgetForwardedPacket(&entry->packet);
+            LoRaPacketsToForward.push_back(entry->packet);
+            logPathHop(&entry->packet, "ENQUEUE_RETX");
+            hopRetransmissions++;
+            retransmitted = entry->packet;
+            retransmit = true;
+            entry++;
+        }
+    }
+    scheduleHopAckTimer();
+    if (retransmit)
+        scheduleForwardPacket(&retransmitted);
+}
+
+void LoRaNodeApp::scheduleHopAckTimer() {
+    simtime_t next = SIMTIME_MAX;
+    for (const auto &entry : hopAcks)
+        next = std::min(next, entry.deadline);
+    if (hopAckTimer->isScheduled()) {
+        if (hopAckTimer->getArrivalTime() == next)
+            return;
+        cancelEvent(hopAckTimer);
+    }
+    if (next != SIMTIME_MAX)
+        scheduleAt(next, hopAckTimer);
+}
+
+void LoRaNodeApp::forgetForwardedPacket(const LoRaAppPacket *packet) {
+    broadcastKey key = getBroadcastKey(packet);
+    for (auto forwarded = LoRaPacketsForwarded.begin(); forwarded != LoRaPacketsForwarded.end(); forwarded++) {
+        if (getBroadcastKey(&*forwarded) == key) {
+            LoRaPacketsForwarded.erase(forwarded);
+            return;
+        }
+    }
+}
+
+int LoRaNodeApp::getAggregationNextHop(const LoRaAppPacket &packet) {
+    // Next hop the packet would get if it were sent on its own, or -1 when that is not known
+    // without a side effect (perimeter walks, dual-metric routes that also pick the SF)
+    switch (routingMetric) {
+        case FLOODING_BROADCAST_SINGLE_SF:
+            return BROADCAST_ADDRESS;
+        case SMART_BROADCAST_SINGLE_SF:
+        case HOP_COUNT_SINGLE_SF:
+        case RSSI_SUM_SINGLE_SF:
+        case RSSI_PROD_SINGLE_SF:
+        case ETX_SINGLE_SF: {
+            int routeIndex = getBestRouteIndexTo(packet.getDestination());
+            if (routeIndex >= 0)
+                return singleMetricRoutingTable[routeIndex].via;
+            return useDSDV ? -1 : BROADCAST_ADDRESS;
+        }
+        case GEOGRAPHIC_SINGLE_SF:
+            if (packet.getPerimeterMode() || !packet.getDestinationKnown())
+                return -1;
+            if (geoNeighbours.isEmpty())
+                return BROADCAST_ADDRESS;
+            return geoNeighbours.findGreedyNextHop(getOwnPosition(), Coord(packet.getDestinationX(), packet.getDestinationY(), 0));
+        default:
+            return -1;
+    }
+}
+
+void LoRaNodeApp::aggregateForwardPackets(LoRaAppPacket *frame, const char *pathTag) {
+    if (!aggregateForwarding || frame->getMsgType() != DATA || frame->getPerimeterMode() || LoRaPacketsToForward.empty())
+        return;
+
+    long frameBytes = frame->getByteLength();
+    std::vector<LoRaAppPacket> extras = LoRaPacketsToForward.extract([&](const LoRaAppPacket &candidate) {
+        long bytes = candidate.getByteLength() + aggregationSubHeaderSize;
+        if (candidate.getMsgType() != DATA || frameBytes + bytes > aggregationMaxPayload)
+            return false;
+        if (getAggregationNextHop(candidate) != frame->getVia())
+            return false;
+        frameBytes += bytes;
+        return true;
+    });
+
+    for (LoRaAppPacket &extra : extras) {
+        forgetBroadcastAssessment(&extra);
+        // Same redundant check as for the frame's own packet
+        if (isPacketForwarded(&extra)) {
+            frameBytes -= extra.getByteLength() + aggregationSubHeaderSize;
+            continue;
+        }
+
+        int index = frame->getAggregatedArraySize();
+        frame->setAggregatedArraySize(index + 1);
+        LoRaAggregatedPacket &entry = frame->getAggregated(index);
+        entry.setMsgType(extra.getMsgType());
+        entry.setDataInt(extra.getDataInt());
+        entry.setSource(extra.getSource());
+        entry.setDestination(extra.getDestination());
+        entry.setTtl(extra.getTtl());
+        entry.setByteLength(extra.getByteLength());
+        entry.setAppACKReq(extra.getOptions().getAppACKReq());
+        entry.setDestinationKnown(extra.getDestinationKnown());
+        entry.setDestinationX(extra.getDestinationX());
+        entry.setDestinationY(extra.getDestinationY());
+        entry.setDepartureTime(extra.getDepartureTime());
+        entry.setHopTrail(extra.getHopTrail());
+
+        forwardedPackets++;
+        forwardedDataPackets++;
+        if (frame->getVia() == BROADCAST_ADDRESS)
+            broadcastForwardedPackets++;
+        LoRaPacketsForwarded.push_back(extra);
+        if (LoRaPacketsForwarded.size() > forwardedPacketVectorSize)
+            LoRaPacketsForwarded.erase(LoRaPacketsForwarded.begin());
+
+        extra.setVia(frame->getVia());
+        logPathHop(&extra, pathTag);
+    }
+
+    if (frame->getAggregatedArraySize() > 0) {
+        frame->setByteLength(frameBytes);
+        aggregatedFramesSent++;
+        aggregatedPacketsSent += frame->getAggregatedArraySize();
+    }
+}
+
+long LoRaNodeApp::getAggregatedBytes(const LoRaAppPacket *frame) const {
+    long bytes = 0;
+    for (unsigned int i = 0; i < frame->getAggregatedArraySize(); i++)
+        bytes += frame->getAggregated(i).getByteLength() + aggregationSubHeaderSize;
+    return bytes;
+}
+
+void LoRaNodeApp::setAggregatedPacket(LoRaAppPacket *packet, const LoRaAggregatedPacket &entry) {
+    // Turns a copy of the frame into the packet the entry describes
+    packet->setAggregatedArraySize(0);
+    packet->setMsgType(entry.getMsgType());
+    packet->setDataInt(entry.getDataInt());
+    packet->setSource(entry.getSource());
+    packet->setDestination(entry.getDestination());
+    packet->setTtl(entry.getTtl());
+    packet->setByteLength(entry.getByteLength());
+    packet->getOptions().setAppACKReq(entry.getAppACKReq());
+    packet->setDestinationKnown(entry.getDestinationKnown());
+    packet->setDestinationX(entry.getDestinationX());
+    packet->setDestinationY(entry.getDestinationY());
+    packet->setPerimeterMode(false);
+    packet->setDepartureTime(entry.getDepartureTime());
+    packet->setHopTrail(entry.getHopTrail());
+}
+
+void LoRaNodeApp::unpackAggregatedFrame(LoRaAppPacket *frame) {
+    // Each carried packet is handled as if it had arrived in a frame of its own
+    aggregatedFramesReceived++;
+    long carriedBytes = getAggregatedBytes(frame);
+    unpackingAggregatedFrame = true;
+    for (unsigned int i = 0; i < frame->getAggregatedArraySize(); i++) {
+        const LoRaAggregatedPacket &entry = frame->getAggregated(i);
+        LoRaAppPacket *packet = frame->dup();
+        setAggregatedPacket(packet, entry);
+        handleMessageFromLowerLayer(packet);
+    }
+    unpackingAggregatedFrame = false;
+    frame->setAggregatedArraySize(0);
+    frame->setByteLength(frame->getByteLength() - carriedBytes);
 }
 
 bool LoRaNodeApp::isDataPacketForMeUnique(cMessage *msg) {
@@ -4161,76 +5367,80 @@ int LoRaNodeApp::pickCADSF() {
 }
 
 int LoRaNodeApp::getBestRouteIndexTo(int destination) {
+    // Scan the table in place (no copies): pass 1 finds the best metric, pass 2 the freshest route with it
     if (singleMetricRoutingTable.size() > 0) {
 
-        int singleMetricRoutesCount = end(singleMetricRoutingTable) - begin(singleMetricRoutingTable);
-
-        std::vector<singleMetricRoute> availableRoutes;
+        int singleMetricRoutesCount = singleMetricRoutingTable.size();
+        int firstRoute = -1;
+        int bestMetric = 0;
 
         for (int i = 0; i < singleMetricRoutesCount; i++) {
             if (singleMetricRoutingTable[i].id == destination) {
-                availableRoutes.push_back(singleMetricRoutingTable[i]);
-
-            }
-        }
-
-        if (availableRoutes.size() > 0) {
-            int bestRoute = 0;
-            int bestMetric = availableRoutes[0].metric;
-
-            int availableRoutesCount = end(availableRoutes) - begin(availableRoutes);
-            for (int j = 0; j < availableRoutesCount; j++) {
-                if (availableRoutes[j].metric < bestMetric) {
-                    bestMetric = availableRoutes[j].metric;
+                if (firstRoute < 0) {
+                    firstRoute = i;
+                    bestMetric = singleMetricRoutingTable[i].metric;
+                }
+                else if (singleMetricRoutingTable[i].metric < bestMetric) {
+                    bestMetric = singleMetricRoutingTable[i].metric;
                 }
             }
+        }
 
+        if (firstRoute >= 0) {
+            int bestRoute = firstRoute;
             simtime_t lastMetric = 0;
 
-            for (int k = 0; k < availableRoutesCount; k++) {
-                if (availableRoutes[k].metric == bestMetric) {
-                    if (availableRoutes[k].valid >= lastMetric) {
+            for (int k = firstRoute; k < singleMetricRoutesCount; k++) {
+                const singleMetricRoute &r = singleMetricRoutingTable[k];
+                if (r.id == destination && r.metric == bestMetric) {
+                    if (r.valid >= lastMetric) {
                         bestRoute = k;
-                        lastMetric = availableRoutes[k].valid;
+                        lastMetric = r.valid;
                     }
                 }
             }
-            return getRouteIndexInSingleMetricRoutingTable(availableRoutes[bestRoute].id, availableRoutes[bestRoute].via);
+            return bestRoute;
         }
     }
     else if (dualMetricRoutingTable.size() > 0) {
         int dualMetricRoutesCount = dualMetricRoutingTable.size();
+        int bestRoute = -1;
 
-        std::vector<dualMetricRoute> availableRoutes;
-
-        for (int i = 0; i < dualMetricRoutesCount; i++) {
-            if (dualMetricRoutingTable[i].id == destination) {
-                availableRoutes.push_back(dualMetricRoutingTable[i]);
+        for (int j = 0; j < dualMetricRoutesCount; j++) {
+            const dualMetricRoute &r = dualMetricRoutingTable[j];
+            if (r.id != destination) {
+                continue;
             }
-        }
-
-        if (availableRoutes.size() > 0) {
-            int bestRoute = 0;
-
-            int availableRoutesCount = end(availableRoutes) - begin(availableRoutes);
-
-            for (int j = 0; j < availableRoutesCount; j++) {
-                if (availableRoutes[j].priMetric < availableRoutes[bestRoute].priMetric ||
-                        ( availableRoutes[j].priMetric == availableRoutes[bestRoute].priMetric &&
-                                availableRoutes[j].secMetric < availableRoutes[bestRoute].secMetric) ||
-                                ( availableRoutes[j].priMetric == availableRoutes[bestRoute].priMetric &&
-                                        availableRoutes[j].secMetric == availableRoutes[bestRoute].secMetric &&
-                                            availableRoutes[j].valid > availableRoutes[bestRoute].valid)) {
-                    bestRoute = j;
-                }
+            if (bestRoute < 0) {
+                bestRoute = j;
+                continue;
             }
-            return getRouteIndexInDualMetricRoutingTable(availableRoutes[bestRoute].id, availableRoutes[bestRoute].via, availableRoutes[bestRoute].sf);
+            const dualMetricRoute &best = dualMetricRoutingTable[bestRoute];
+            if (r.priMetric < best.priMetric ||
+                    ( r.priMetric == best.priMetric && r.secMetric < best.secMetric) ||
+                    ( r.priMetric == best.priMetric && r.secMetric == best.secMetric && r.valid > best.valid)) {
+                bestRoute = j;
+            }
+        }
+        if (bestRoute >= 0) {
+            return bestRoute;
         }
     }
 
     return -1;
 }
 
+std::uint32_t LoRaNodeApp::getRouteSeqNum(int id) const {
+    auto it = dsdvRouteState.find(id);
+    return it != dsdvRouteState.end() ? it->second.seqNum : 0;
+}
+
+void LoRaNodeApp::setRouteSeqNum(int id, std::uint32_t seqNum) {
+    dsdvRouteInfo &info = dsdvRouteState[id];
+    info.seqNum = seqNum;
+    info.installTime = simTime();
+}
+
 // ---------------------------------------------------------------
 // Helper: Remove any routing entries that do NOT correspond to end
 // nodes. End nodes have been offset to IDs >= 1000. We optionally
@@ -4377,6 +5587,25 @@ simtime_t LoRaNodeApp::calculateTransmissionDuration(cMessage *msg) {
 }
 
 
+void LoRaNodeApp::scheduleDsdvTimers() {
+    // Schedule periodic DSDV timers with random jitter to avoid synchronization
+    // Jitter range: uniform(jitterMin, jitterMax)
+    simtime_t incrementalJitter = uniform(dsdvTimerJitterMin.dbl(), dsdvTimerJitterMax.dbl());
+    simtime_t fullJitter = uniform(dsdvTimerJitterMin.dbl(), dsdvTimerJitterMax.dbl());
+
+    simtime_t nextIncrementalUpdate = simTime() + dsdvIncrementalPeriod + incrementalJitter;
+    simtime_t nextFullUpdate = simTime() + dsdvFullUpdatePeriod + fullJitter;
+
+    // Create and schedule DSDV timer messages (use member variables)
+    dsdvIncrementalTimer = new cMessage("dsdvIncrementalTimer");
+    dsdvFullTimer = new cMessage("dsdvFullTimer");
+
+    EV_WARN << "[DEBUG-TIMER] Node " << nodeId << " scheduling dsdvIncrementalTimer for t=" << nextIncrementalUpdate << endl;
+    scheduleAt(nextIncrementalUpdate, dsdvIncrementalTimer);
+    EV_WARN << "[DEBUG-TIMER] Node " << nodeId << " scheduling dsdvFullTimer for t=" << nextFullUpdate << endl;
+    scheduleAt(nextFullUpdate, dsdvFullTimer);
+}
+
 // ---------------- Failure handling & export helpers ----------------
 
 void LoRaNodeApp::scheduleFailure() {
@@ -4393,7 +5622,7 @@ void LoRaNodeApp::scheduleFailure() {
     scheduleAt(simTime() + scheduleDelay, failureEvent);
 }
 
-void LoRaNodeApp::performFailure() {
+void LoRaNodeApp::performFailure(bool crashNode) {
     if (failed) return; // idempotent
     failed = true;
     failureTime = simTime();
@@ -4411,19 +5640,43 @@ void LoRaNodeApp::performFailure() {
         dsdvFullTimer = nullptr;
     }
 
+    // Broadcasts still being assessed are lost with the node's buffers
+    if (broadcastAssessmentTimer)
+        cancelEvent(broadcastAssessmentTimer);
+    for (auto it = broadcastAssessments.begin(); it != broadcastAssessments.end(); )
+        it = it->second.queued ? std::next(it) : broadcastAssessments.erase(it);
+    // So are the packets waiting for an implicit ACK
+    if (hopAckTimer)
+        cancelEvent(hopAckTimer);
+    hopAcks.clear();
+
     // Release failureEvent (processed)
     if (failureEvent) {
         delete failureEvent;
         failureEvent = nullptr;
     }
 
+    // Crash the radio and the MAC: the radio switches off and the medium stops
+    // computing arrivals and receptions for it until the node recovers
+    waitingForMacReady = false;
+    if (failureCrashesNode && crashNode)
+        applyNodeOperation(getContainingNode(this), new NodeCrashOperation(), this);
+
+    // Optional recovery process, drawn per failure (timeToRecovery is volatile);
+    // failures driven by a node operation recover with the matching start
+    simtime_t timeToRecovery = crashNode ? par("timeToRecovery").doubleValue() : -1;
+    if (timeToRecovery >= SIMTIME_ZERO && !recoveryEvent) {
+        recoveryEvent = new cMessage("recoveryEvent");
+        scheduleAt(simTime() + timeToRecovery, recoveryEvent);
+    }
+
     // Append a failure record to delivered_packets/node_failures.txt
     appendNodeFailure(nodeId, failureTime);
 
     bubble("Node FAILED (simulated random failure)");
     // Record immediate scalars if not already
-    recordScalar("failed", 1);
-    recordScalar("failureTime", failureTime);
+    LoRaScalarCollector::record(this, "failed", 1);
+    LoRaScalarCollector::record(this, "failureTime", failureTime);
     // Visual indication in GUI (if running Qtenv)
     cModule *parentNode = getParentModule();
     if (parentNode) {
@@ -4439,6 +5692,42 @@ void LoRaNodeApp::performFailure() {
     }
 }
 
+void LoRaNodeApp::performRecovery(bool startNode) {
+    if (recoveryEvent) {
+        cancelAndDelete(recoveryEvent);
+        recoveryEvent = nullptr;
+    }
+    if (!failed) return;
+    failed = false;
+    recoveryTime = simTime();
+    recoveryCount++;
+
+    if (failureCrashesNode && startNode)
+        applyNodeOperation(getContainingNode(this), new NodeStartOperation(), this);
+
+    // Restart the timers performFailure() stopped; the routing table is kept
+    // and its stale entries age out as on any other node
+    if (useDSDV && !globalConvergedFired && !dsdvIncrementalTimer && !dsdvFullTimer)
+        scheduleDsdvTimers();
+    if (!selfPacket) {
+        selfPacket = new cMessage("selfPacket");
+        selfPacket->setSchedulingPriority(-10);
+    }
+    if (!selfPacket->isScheduled())
+        scheduleAt(simTime() + 10*simTimeResolution, selfPacket);
+
+    EV_WARN << "[Failure] Node " << nodeId << " recovered at t=" << recoveryTime
+            << " after " << (recoveryTime - failureTime) << " s down" << endl;
+    bubble("Node RECOVERED");
+    cModule *parentNode = getParentModule();
+    if (parentNode) {
+        cDisplayString &ds = parentNode->getDisplayString();
+        ds.removeTag("b");
+        ds.setTagArg("i", 1, "");
+        ds.setTagArg("tt", 0, (std::string("RECOVERED at ")+recoveryTime.str()).c_str());
+    }
+}
+
 void LoRaNodeApp::exportRoutingTables() {
     // Ensure directory exists (reuse logic similar to openRoutingCsv)
 #if 0
@@ -4469,7 +5758,7 @@ void LoRaNodeApp::exportRoutingTables() {
             ofs << "id,via,metric,validUntil,seqNum,isValid" << std::endl;
             for (auto &r : singleMetricRoutingTable) {
                 ofs << r.id << ',' << r.via << ',' << r.metric << ',' << r.valid 
-                    << ',' << r.seqNum << ',' << (r.isValid ? "true" : "false") << std::endl;
+                    << ',' << getRouteSeqNum(r.id) << ',' << (r.isValid ? "true" : "false") << std::endl;
             }
         }
     }
@@ -4495,7 +5784,7 @@ void LoRaNodeApp::exportRoutingTables() {
             txt << "Single-metric entries: " << singleMetricRoutingTable.size() << "\n";
             for (auto &r : singleMetricRoutingTable) {
                 txt << " dest=" << r.id << " via=" << r.via << " metric=" << r.metric 
-                    << " validUntil=" << r.valid << " seqNum=" << r.seqNum 
+                    << " validUntil=" << r.valid << " seqNum=" << getRouteSeqNum(r.id) 
                     << " isValid=" << (r.isValid ? "true" : "false") << "\n";
             }
             txt << "Dual-metric entries: " << dualMetricRoutingTable.size() << "\n";
@@ -4525,6 +5814,12 @@ bool LoRaNodeApp::globalConvergedFired = false;
 std::string LoRaNodeApp::globalConvergenceCsvPath = std::string();
 bool LoRaNodeApp::globalConvergenceCsvReady = false;
 
+// -------- Global data-done tracker static members --------
+int LoRaNodeApp::globalNodesExpectingDataDone = 0;
+std::unordered_map<int, int> LoRaNodeApp::geoLocationModules;
+int LoRaNodeApp::globalNodesDataDone = 0;
+bool LoRaNodeApp::globalDataDoneFired = false;
+
 void LoRaNodeApp::initGlobalFailureSelection() {
     // Read parameters (each instance sees same values); perform selection once
     int subsetCount = par("globalFailureSubsetCount");
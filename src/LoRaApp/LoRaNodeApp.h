@@ -22,8 +22,12 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <cstdint>
+#include <cmath>
 // CSV logging
 #include <fstream>
+#include <map>
+#include <tuple>
+#include <vector>
 
 #include "inet/common/lifecycle/ILifecycle.h"
 #include "inet/common/lifecycle/NodeStatus.h"
@@ -31,8 +35,17 @@
 #include "inet/common/lifecycle/LifecycleOperation.h"
 #include "inet/common/FSMA.h"
 
+#include "inet/mobility/contract/IMobility.h"
+
 #include "LoRaAppPacket_m.h"
+#include "LoRaFlowStatistics.h"
+#include "LoRaForwardQueue.h"
+#include "LoRaGeoNeighbourTable.h"
+#include "LoRaLinkTable.h"
+#include "LoRaTrafficModel.h"
+#include "LoRaTrafficWheel.h"
 #include "LoRa/LoRaMacControlInfo_m.h"
+#include "misc/LoRaStreamingStatistic.h"
 
 using namespace omnetpp;
 
@@ -41,7 +54,7 @@ namespace inet {
 /**
  * TODO - Generated class
  */
-class INET_API LoRaNodeApp : public cSimpleModule, public ILifecycle
+class INET_API LoRaNodeApp : public cSimpleModule, public ILifecycle, public cListener, public LoRaTrafficWheel::IClient
 {
     protected:
         // Forward declaration so we can reference the nested type in prototypes above its definition
@@ -52,6 +65,7 @@ class INET_API LoRaNodeApp : public cSimpleModule, public ILifecycle
         virtual int numInitStages() const override { return NUM_INIT_STAGES; }
         virtual void handleMessage(cMessage *msg) override;
         virtual bool handleOperationStage(LifecycleOperation *operation, int stage, IDoneCallback *doneCallback) override;
+        virtual void receiveSignal(cComponent *source, simsignal_t signalID, bool b, cObject *details) override;
         virtual bool isNeighbour(int neighbourId);
         virtual bool isRouteInSingleMetricRoutingTable(int id, int via);
         virtual int  getRouteIndexInSingleMetricRoutingTable(int id, int via);
@@ -61,6 +75,7 @@ class INET_API LoRaNodeApp : public cSimpleModule, public ILifecycle
         virtual bool isACKed(int nodeId);
         virtual bool isPacketForwarded(cMessage *msg);
         virtual bool isPacketToBeForwarded(cMessage *msg);
+        void scheduleForwardPacket(const LoRaAppPacket *packet);
         virtual bool isDataPacketForMeUnique(cMessage *msg);
         virtual bool shouldFilterDestination(int destId);
 
@@ -87,6 +102,14 @@ class INET_API LoRaNodeApp : public cSimpleModule, public ILifecycle
         void sendJoinRequest();
         void sendDownMgmtPacket();
         void generateDataPackets();
+        void initDataCursor();
+        void queueDataPacket(int destination);
+        void generateNextDataPacket();
+        int getDataCursorDestination(long packetIndex) const;
+        int permuteDataCursorIndex(int index) const;
+        long getPendingDataPacketCount() const;
+        void startTrafficModel();
+        virtual void handleTrafficArrival(int kind) override;
         void sanitizeRoutingTable();
     void filterRoutesToEndNodes(); // keep only end-node (ID>=1000) routes
     // When enabled (storeBestRouteOnly), ensure at most one route per destination id
@@ -97,10 +120,16 @@ class INET_API LoRaNodeApp : public cSimpleModule, public ILifecycle
 
         // Failure simulation helpers
         void scheduleFailure();
-        void performFailure();
+        void performFailure(bool crashNode = true);
+        void performRecovery(bool startNode = true);
+        void scheduleDsdvTimers();
         bool failed = false;
         cMessage *failureEvent = nullptr;
         simtime_t failureTime = -1;
+        bool failureCrashesNode = true;       // failure crashes the radio and MAC, taking the node off the medium
+        cMessage *recoveryEvent = nullptr;
+        simtime_t recoveryTime = -1;
+        long recoveryCount = 0;
         double failureJitterFracParam = 0;
         simtime_t timeToFailureParam = -1;
 
@@ -115,6 +144,9 @@ class INET_API LoRaNodeApp : public cSimpleModule, public ILifecycle
     // Path logging (per-hop) for ALL data packets (filter by destination offline)
     void logPathHop(const LoRaAppPacket *packet, const char *eventTag);
     void ensurePathLogInitialized();
+    // Hop trail carried by DATA packets, written once on delivery
+    void appendHopTrail(LoRaHopTrail &trail) const;
+    void logHopTrail(const LoRaAppPacket *packet);
 
     // Global failure subset (shared across instances)
     static bool globalFailureInitialized;        // whether subset was chosen
@@ -137,6 +169,27 @@ class INET_API LoRaNodeApp : public cSimpleModule, public ILifecycle
         int numberOfDestinationsPerNode;
         int numberOfPacketsPerDestination;
 
+        // Lazy data traffic: packet i goes to destination permutation[i % dataCursorDestinations],
+        // where the permutation of the candidate nodes is a 4-round Feistel network keyed by dataCursorKeys
+        bool lazyDataPackets;
+        int dataCursorDestinations = 0;
+        int dataCursorCandidates = 0;
+        int dataCursorHalfBits = 1;
+        uint32_t dataCursorKeys[4] = { };
+        int dataCursorForcedDestination = -1;
+        long dataCursorNext = 0;
+        long dataCursorTotal = 0;
+        simtime_t dataCursorStartTime;  // when the batch was generated: departure time of every lazy packet
+
+        // Traffic model (trafficModel != "none"): packets are queued on arrivals delivered by the shared wheel
+        LoRaTrafficModel *trafficModel = nullptr;
+        LoRaTrafficWheel *trafficWheel = nullptr;
+        LoRaFlowStatistics *flowStatistics = nullptr;
+        int trafficMaxPackets = -1;
+        long trafficPacketIndex = 0;
+        long trafficArrivals = 0;
+        long trafficAlarmReports = 0;
+
         int numberOfPacketsToForward;
 
         int sentPackets;
@@ -228,13 +281,18 @@ class INET_API LoRaNodeApp : public cSimpleModule, public ILifecycle
         cMessage *configureLoRaParameters;
         cMessage *selfPacket;
 
-        //history of sent packets;
-        cOutVector txSfVector;
-        cOutVector txTpVector;
+        // MAC-ready notification: park selfPacket while the MAC is busy instead of polling it
+        bool waitForMacReady = true;          // parameter value
+        bool waitingForMacReady = false;      // selfPacket is parked until LoRaMac re-enters IDLE
+        int macBusyDeferrals = 0;             // how many times a due transmission found the MAC busy
+
+        //history of sent packets (txStatistic);
+        LoRaStreamingStatistic txSfVector;
+        LoRaStreamingStatistic txTpVector;
 
-        // History of received packets
-        cOutVector rxRssiVector;
-        cOutVector rxSfVector;
+        // History of received packets (rxStatistic)
+        LoRaStreamingStatistic rxRssiVector;
+        LoRaStreamingStatistic rxSfVector;
 
         // cOutVector DistanceX;
         // cOutVector DistanceY;
@@ -278,7 +336,7 @@ class INET_API LoRaNodeApp : public cSimpleModule, public ILifecycle
         std::vector<int> knownNodes;
         std::vector<int> ACKedNodes;
         std::vector<LoRaAppPacket> LoRaPacketsToSend;
-        std::vector<LoRaAppPacket> LoRaPacketsToForward;
+        LoRaForwardQueue LoRaPacketsToForward;
         std::vector<LoRaAppPacket> LoRaPacketsForwarded;
         std::vector<LoRaAppPacket> DataPacketsForMe;
 
@@ -302,25 +360,151 @@ class INET_API LoRaNodeApp : public cSimpleModule, public ILifecycle
         //Forwarded packets vector size
         int forwardedPacketVectorSize;
 
+        // Broadcast suppression (FLOODING/SMART_BROADCAST): a new broadcast to forward waits a random
+        // assessment delay before it enters LoRaPacketsToForward, and is dropped, or removed from the
+        // queue before transmission, once the copies overheard make the rebroadcast redundant
+        enum BroadcastSuppression {
+            SUPPRESSION_NONE,
+            SUPPRESSION_COUNTER,   // heard suppressionCounterThreshold copies
+            SUPPRESSION_DISTANCE,  // heard a copy above suppressionRssiThreshold, i.e. from a close transmitter
+            SUPPRESSION_COVERAGE   // every neighbour heard recently has transmitted, or originated, a copy
+        };
+        struct broadcastAssessment {
+            LoRaAppPacket packet;           // TTL already decremented
+            simtime_t deadline;             // end of the assessment delay
+            bool queued = false;            // released to LoRaPacketsToForward, not yet transmitted
+            int copies = 0;
+            double maxRssi = -INFINITY;
+            std::vector<int> coveredNodes;  // source and transmitters of the copies heard
+        };
+        typedef std::tuple<int, int, int, int> broadcastKey;  // msgType, dataInt, source, destination
+        int broadcastSuppression = SUPPRESSION_NONE;
+        double suppressionAssessmentDelay = 0;
+        int suppressionCounterThreshold = 3;
+        double suppressionRssiThreshold = -100;
+        simtime_t suppressionNeighbourTimeout;
+        std::map<broadcastKey, broadcastAssessment> broadcastAssessments;
+        std::unordered_map<int, simtime_t> heardNeighbours;  // lastHop -> last time heard (coverage policy)
+        cMessage *broadcastAssessmentTimer = nullptr;
+        int broadcastsSuppressed = 0;         // dropped at the end of the assessment delay
+        int queuedBroadcastsCanceled = 0;     // removed from LoRaPacketsToForward before transmission
+        static broadcastKey getBroadcastKey(const LoRaAppPacket *packet);
+        bool isBroadcastSuppressible(const LoRaAppPacket *packet) const;
+        void startBroadcastAssessment(const LoRaAppPacket *received, const LoRaAppPacket &toForward);
+        bool updateBroadcastAssessment(const LoRaAppPacket *copy);
+        bool isBroadcastRedundant(const broadcastAssessment &assessment) const;
+        void releaseAssessedBroadcasts();
+        void scheduleBroadcastAssessmentTimer();
+        void forgetBroadcastAssessment(const LoRaAppPacket *packet);
+
+        // Geographic forwarding (GEOGRAPHIC_SINGLE_SF): greedy towards the destination position carried by
+        // the packet, perimeter mode at local maxima; neighbour positions come from overheard frames
+        IMobility *hostMobility = nullptr;
+        LoRaGeoNeighbourTable geoNeighbours;
+        simtime_t geoNeighbourTimeout;
+        int geoGreedyHops = 0;
+        int geoPerimeterHops = 0;
+        int geoFallbackBroadcasts = 0;        // no destination position or no neighbour known yet
+        int geoPerimeterDrops = 0;            // face walked around without getting closer
+        static std::unordered_map<int, int> geoLocationModules;  // nodeId -> mobility module id
+        Coord getOwnPosition() const;
+        bool getNodePosition(int id, Coord &position) const;
+        void stampLastHop(LoRaAppPacket *packet);
+        bool isPerimeterRevisit(const LoRaAppPacket *packet) const;
+        int getGeographicNextHop(LoRaAppPacket *packet);
+
         //Forward packets buffer max vector size
         int packetsToForwardMaxVectorSize;
 
+        // Fair forwarding (forwardScheduling = "drr"): per-flow forward queues served by deficit round
+        // robin, and the same between own and forwarded packets instead of the ownDataPriority coin
+        bool fairForwarding = false;
+        long drrQuantum = 64;              // bytes per turn
+        long ownDataDeficit = 0;
+        long forwardDeficit = 0;
+        bool ownDataTurn = true;
+        bool drrTurnStarted = false;
+        bool isOwnDataTurn();
+        void chargeTransmission(bool localData, long bytes);
+        bool recordFlowLatency = false;         // fairForwarding or flowLatencyStatistics
+        std::map<int, cHistogram> flowLatency;  // source -> latency of the unique packets received from it
+        std::unordered_map<int, std::unordered_set<int>> flowDeliveredSequences;  // source -> dataInts delivered here
+
+        // Link adaptation: unicasts to a neighbour whose path loss is known use the lowest SF (only with
+        // CAD, as receivers otherwise listen on loRaSF alone) and power that keep linkAdaptationMargin;
+        // broadcasts keep loRaSF/loRaTP
+        bool linkAdaptation = false;
+        double linkAdaptationMargin = 10;   // dB
+        double minLoRaTP = 2;               // dBm
+        simtime_t linkTimeout;
+        LoRaLinkTable links;
+        bool unpackingAggregatedFrame = false;
+        int linkAdaptedFrames = 0;
+        long linkAdaptationSFSaved = 0;     // SF steps below loRaSF, summed over frames
+        double linkAdaptationTPSaved = 0;   // dB below loRaTP, summed over frames
+        void adaptToLink(LoRaMacControlInfo *cInfo, int nextHop);
+
+        // Implicit hop-by-hop ACKs: unicast DATA packets waiting to be overheard from their next hop,
+        // all served by one timer set to the earliest deadline
+        struct hopAckEntry {
+            LoRaAppPacket packet;   // as sent, for the retransmission
+            int nextHop;
+            simtime_t deadline;
+            int retries = 0;
+        };
+        bool implicitAcks = false;
+        simtime_t implicitAckTimeout;
+        int implicitAckMaxRetries = 3;
+        std::vector<hopAckEntry> hopAcks;
+        cMessage *hopAckTimer = nullptr;
+        int implicitAcksHeard = 0;
+        int hopRetransmissions = 0;
+        int hopRetransmissionFailures = 0;  // given up after implicitAckMaxRetries
+        int implicitAckRepeats = 0;         // already forwarded packets forwarded again for a retransmitting sender
+        void expectImplicitAck(const LoRaAppPacket *packet, simtime_t txDuration);
+        void acknowledgeImplicitly(const LoRaAppPacket *packet);
+        void retransmitUnacknowledged();
+        void scheduleHopAckTimer();
+        void forgetForwardedPacket(const LoRaAppPacket *packet);
+
+        // Relay aggregation: queued DATA packets for the same next hop ride along in one frame
+        bool aggregateForwarding = false;
+        long aggregationMaxPayload = 247;   // bytes
+        long aggregationSubHeaderSize = 6;  // bytes per extra packet
+        int aggregatedFramesSent = 0;
+        int aggregatedPacketsSent = 0;      // extra packets, not counting the frames' own
+        int aggregatedFramesReceived = 0;
+        int getAggregationNextHop(const LoRaAppPacket &packet);
+        void aggregateForwardPackets(LoRaAppPacket *frame, const char *pathTag);
+        void unpackAggregatedFrame(LoRaAppPacket *frame);
+        long getAggregatedBytes(const LoRaAppPacket *frame) const;
+        static void setAggregatedPacket(LoRaAppPacket *packet, const LoRaAggregatedPacket &entry);
+
         // Routing tables
+        // Hot route entry: everything route lookup and forwarding touch, 40 bytes per entry.
+        // DSDV-only state lives in the dsdvRouteState side-table below.
         class singleMetricRoute {
 
             public:
                 int id;
                 int via;
                 double metric;
-                int window[33];
                 simtime_t valid;       // existing validity timestamp
-                // DSDV additions
-                std::uint32_t seqNum;  // destination sequence number
+                std::uint64_t window;  // ETX: bit i set if routing packet (windowLastSeq - i) was received
+                int windowLastSeq;     // ETX: sequence number of the newest routing packet in window
                 bool isValid;          // explicit valid/invalid flag (distinct from timestamp)
-                simtime_t installTime; // when this route was installed/updated
         };
         std::vector<singleMetricRoute> singleMetricRoutingTable;
 
+        // Cold DSDV state per destination, only read when building/processing DSDV updates
+        struct dsdvRouteInfo {
+            std::uint32_t seqNum;  // destination sequence number
+            simtime_t installTime; // when the route to this destination was installed/updated
+        };
+        std::unordered_map<int, dsdvRouteInfo> dsdvRouteState;
+        std::uint32_t getRouteSeqNum(int id) const;
+        void setRouteSeqNum(int id, std::uint32_t seqNum);
+
         class dualMetricRoute {
 
             public:
@@ -328,7 +512,6 @@ class INET_API LoRaNodeApp : public cSimpleModule, public ILifecycle
                 int via;
                 double priMetric;
                 double secMetric;
-                int window[33];
                 int sf;
                 simtime_t valid;
         };
@@ -338,6 +521,26 @@ class INET_API LoRaNodeApp : public cSimpleModule, public ILifecycle
     std::ofstream routingCsv;
     bool routingCsvReady = false;
     std::string routingCsvPath;
+    // Routing log mode: "snapshot" (rewrite node_<id>_routing.csv), "journal" (append changes to
+    // node_<id>_routing_journal.csv, see simulations/routing_journal_materialize.py) or "none"
+    std::string routingLogMode = "snapshot";
+    std::ofstream routingJournal;
+    bool routingJournalReady = false;
+    std::vector<char> routingJournalBuffer;
+    // Last journalled state of every route, keyed by (id, via, sf); sf = -1 for single-metric routes
+    struct routingJournalRow {
+        double metric;
+        double priMetric;
+        double secMetric;
+        simtime_t valid;
+        uint32_t seqNum;
+        bool isValid;
+        unsigned generation;
+    };
+    std::map<std::tuple<int, int, int>, routingJournalRow> routingJournalShadow;
+    unsigned routingJournalGeneration = 0;
+    void logRoutingJournal(const char *eventName);
+    void writeRoutingJournalRow(const char *eventName, const char *op, const std::tuple<int, int, int> &key, const routingJournalRow &row);
 
     // Delivered packets CSV state
     std::ofstream deliveredCsv;
@@ -345,6 +548,8 @@ class INET_API LoRaNodeApp : public cSimpleModule, public ILifecycle
     std::string deliveredCsvPath;
 
     // Path log state (shared single file across all nodes)
+    bool pathLog = true;
+    bool hopTrail = false;
     bool pathLogReady = false;
     std::string pathLogFile; // delivered_packets/paths.csv
 
@@ -376,6 +581,19 @@ class INET_API LoRaNodeApp : public cSimpleModule, public ILifecycle
     void announceLocalConvergenceIfNeeded(int uniqueCount);
     void tryStopRoutingGlobally();
 
+    // Global "all nodes done with data" tracker (replaces the per-send scan over every loRaNodes[i])
+    // A node counts itself done once its last data TX/RX is older than stopRoutingAfterDataDone;
+    // when every participant is done the shared flag stops routing beacons network-wide.
+    bool dataDoneParticipant = false;             // this node is one of loRaNodes[0..numberOfNodes-1]
+    bool dataDoneCounted = false;                 // this node is currently included in globalNodesDataDone
+    cMessage *dataDoneTimer = nullptr;            // fires when this node may have become done
+    simtime_t dataDoneLastActivity;               // data TX/RX time the tracker last saw
+    static int globalNodesExpectingDataDone;      // number of participants
+    static int globalNodesDataDone;               // participants currently done
+    static bool globalDataDoneFired;              // latched once every participant was done
+    void updateDataDoneTracker();                 // call after lastDataPacket{Transmission,Reception}Time change
+    void handleDataDoneTimer();
+
     // DSDV node-local state
     bool useDSDV = false;                                   // true if DSDV protocol selected
     cMessage *dsdvIncrementalTimer = nullptr;               // periodic incremental update timer
@@ -410,6 +628,8 @@ class INET_API LoRaNodeApp : public cSimpleModule, public ILifecycle
 
     public:
         LoRaNodeApp() {}
+        int getNodeId() const { return nodeId; }
+        bool isFailed() const { return failed; }
         simsignal_t LoRa_AppPacketSent;
         simsignal_t LoRa_AppPacketDelivered;
         //LoRa physical layer parameters
@@ -0,0 +1,49 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include "LoRaNodeOperations.h"
+
+#include "inet/common/lifecycle/ILifecycle.h"
+
+namespace inet {
+
+namespace {
+
+void applyNodeOperationStage(cModule *module, LifecycleOperation *operation, int stage, const cModule *skip)
+{
+    for (cModule::SubmoduleIterator it(module); !it.end(); ++it) {
+        cModule *submodule = *it;
+        if (submodule == skip)
+            continue;
+        ILifecycle *lifecycle = dynamic_cast<ILifecycle *>(submodule);
+        if (lifecycle && !lifecycle->handleOperationStage(operation, stage, nullptr))
+            EV_WARN << submodule->getFullPath() << " did not complete stage " << stage
+                    << " of " << operation->getClassName() << " immediately" << endl;
+        applyNodeOperationStage(submodule, operation, stage, skip);
+    }
+}
+
+}
+
+void applyNodeOperation(cModule *host, LifecycleOperation *operation, const cModule *skip)
+{
+    LifecycleOperation::StringMap params;
+    operation->initialize(host, params);
+    for (int stage = 0; stage < operation->getNumStages(); stage++)
+        applyNodeOperationStage(host, operation, stage, skip);
+    delete operation;
+}
+
+}
@@ -0,0 +1,39 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#ifndef __LORA_OMNET_LORANODEOPERATIONS_H_
+#define __LORA_OMNET_LORANODEOPERATIONS_H_
+
+#include <omnetpp.h>
+
+#include "inet/common/lifecycle/LifecycleOperation.h"
+
+using namespace omnetpp;
+
+namespace inet {
+
+/**
+ * Applies a node lifecycle operation (NodeCrashOperation, NodeStartOperation,
+ * ...) to every ILifecycle submodule of the host, stage by stage, in the same
+ * order as LifecycleController. LoRa nodes have no NodeStatus, and their
+ * radio, MAC, interface table and application complete every stage
+ * synchronously, so no ScenarioManager is needed. The skipped module, if any,
+ * is the caller updating its own state. Takes ownership of the operation.
+ */
+void applyNodeOperation(cModule *host, LifecycleOperation *operation, const cModule *skip = nullptr);
+
+}
+
+#endif
@@ -0,0 +1,82 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include "LoRaTrafficModel.h"
+
+#include <cstring>
+
+namespace inet {
+
+LoRaTrafficModel *LoRaTrafficModel::create(cComponent *owner)
+{
+    const char *model = owner->par("trafficModel").stringValue();
+    if (strcmp(model, "none") == 0)
+        return nullptr;
+    else if (strcmp(model, "periodic") == 0)
+        return new PeriodicTrafficModel(owner, owner->par("trafficPeriod").doubleValue(), owner->par("trafficPeriodJitter").doubleValue());
+    else if (strcmp(model, "poisson") == 0)
+        return new PoissonTrafficModel(owner, owner->par("trafficMeanInterval").doubleValue());
+    else if (strcmp(model, "onoff") == 0)
+        return new OnOffTrafficModel(owner, owner->par("trafficMeanInterval").doubleValue(), owner->par("trafficOnMean").doubleValue(), owner->par("trafficOffMean").doubleValue());
+    else if (strcmp(model, "alarm") == 0)
+        return new AlarmTrafficModel(owner);
+    throw cRuntimeError("Unknown trafficModel '%s' (none, periodic, poisson, onoff or alarm)", model);
+}
+
+simtime_t PeriodicTrafficModel::getFirstArrivalTime(simtime_t startTime)
+{
+    // Random phase, so that nodes started together do not report in lockstep
+    return startTime + owner->uniform(0, period.dbl());
+}
+
+simtime_t PeriodicTrafficModel::getNextArrivalTime(simtime_t lastArrivalTime)
+{
+    simtime_t next = lastArrivalTime + period;
+    if (jitter > 0)
+        next += owner->uniform(0, jitter.dbl());
+    return next;
+}
+
+simtime_t PoissonTrafficModel::getFirstArrivalTime(simtime_t startTime)
+{
+    return startTime + owner->exponential(meanInterval.dbl());
+}
+
+simtime_t PoissonTrafficModel::getNextArrivalTime(simtime_t lastArrivalTime)
+{
+    return lastArrivalTime + owner->exponential(meanInterval.dbl());
+}
+
+simtime_t OnOffTrafficModel::getFirstArrivalTime(simtime_t startTime)
+{
+    // Start in the OFF state
+    simtime_t onPeriodStart = startTime + owner->exponential(offMean.dbl());
+    onPeriodEnd = onPeriodStart + owner->exponential(onMean.dbl());
+    return getNextArrivalTime(onPeriodStart);
+}
+
+simtime_t OnOffTrafficModel::getNextArrivalTime(simtime_t lastArrivalTime)
+{
+    simtime_t next = lastArrivalTime + owner->exponential(meanInterval.dbl());
+    // Memoryless arrivals: an arrival falling into the OFF period moves to the next ON period
+    while (next > onPeriodEnd) {
+        simtime_t onPeriodStart = onPeriodEnd + owner->exponential(offMean.dbl());
+        onPeriodEnd = onPeriodStart + owner->exponential(onMean.dbl());
+        next = onPeriodStart + owner->exponential(meanInterval.dbl());
+    }
+    return next;
+}
+
+}
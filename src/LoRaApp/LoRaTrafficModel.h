@@ -0,0 +1,123 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#ifndef __LORA_OMNET_LORATRAFFICMODEL_H_
+#define __LORA_OMNET_LORATRAFFICMODEL_H_
+
+#include <omnetpp.h>
+
+using namespace omnetpp;
+
+namespace inet {
+
+/**
+ * Data arrival process of one node. The model only decides when the next
+ * packet arrives; the node builds the packet and the shared LoRaTrafficWheel
+ * delivers the arrival. Random numbers are drawn from the owner module's RNGs.
+ */
+class LoRaTrafficModel
+{
+    protected:
+        cComponent *owner;
+
+    public:
+        LoRaTrafficModel(cComponent *owner) : owner(owner) {}
+        virtual ~LoRaTrafficModel() {}
+
+        /**
+         * Time of the first arrival, at or after the given start time, or a
+         * negative value if the model produces no arrivals of its own.
+         */
+        virtual simtime_t getFirstArrivalTime(simtime_t startTime) = 0;
+        /**
+         * Time of the next arrival after the one at the given time.
+         */
+        virtual simtime_t getNextArrivalTime(simtime_t lastArrivalTime) = 0;
+        /**
+         * True if the node reports the alarm events raised by the wheel.
+         */
+        virtual bool reportsAlarms() const { return false; }
+
+        /**
+         * Creates the model selected by the owner's trafficModel parameter,
+         * or returns nullptr for "none".
+         */
+        static LoRaTrafficModel *create(cComponent *owner);
+};
+
+/**
+ * Sensor reporting every trafficPeriod, with a random phase and an optional
+ * uniform jitter of up to trafficPeriodJitter per report.
+ */
+class PeriodicTrafficModel : public LoRaTrafficModel
+{
+    protected:
+        simtime_t period;
+        simtime_t jitter;
+
+    public:
+        PeriodicTrafficModel(cComponent *owner, simtime_t period, simtime_t jitter) : LoRaTrafficModel(owner), period(period), jitter(jitter) {}
+        virtual simtime_t getFirstArrivalTime(simtime_t startTime) override;
+        virtual simtime_t getNextArrivalTime(simtime_t lastArrivalTime) override;
+};
+
+/**
+ * Poisson arrivals with mean inter-arrival time trafficMeanInterval.
+ */
+class PoissonTrafficModel : public LoRaTrafficModel
+{
+    protected:
+        simtime_t meanInterval;
+
+    public:
+        PoissonTrafficModel(cComponent *owner, simtime_t meanInterval) : LoRaTrafficModel(owner), meanInterval(meanInterval) {}
+        virtual simtime_t getFirstArrivalTime(simtime_t startTime) override;
+        virtual simtime_t getNextArrivalTime(simtime_t lastArrivalTime) override;
+};
+
+/**
+ * Bursty on/off source: exponentially distributed ON and OFF periods, Poisson
+ * arrivals with mean trafficMeanInterval while ON and none while OFF.
+ */
+class OnOffTrafficModel : public LoRaTrafficModel
+{
+    protected:
+        simtime_t meanInterval;
+        simtime_t onMean;
+        simtime_t offMean;
+        simtime_t onPeriodEnd;
+
+    public:
+        OnOffTrafficModel(cComponent *owner, simtime_t meanInterval, simtime_t onMean, simtime_t offMean) : LoRaTrafficModel(owner), meanInterval(meanInterval), onMean(onMean), offMean(offMean) {}
+        virtual simtime_t getFirstArrivalTime(simtime_t startTime) override;
+        virtual simtime_t getNextArrivalTime(simtime_t lastArrivalTime) override;
+};
+
+/**
+ * Event-triggered reporting: the node sends nothing on its own and reports
+ * every alarm the wheel raises within alarmRadius of it.
+ */
+class AlarmTrafficModel : public LoRaTrafficModel
+{
+    public:
+        AlarmTrafficModel(cComponent *owner) : LoRaTrafficModel(owner) {}
+        virtual simtime_t getFirstArrivalTime(simtime_t startTime) override { return -1; }
+        virtual simtime_t getNextArrivalTime(simtime_t lastArrivalTime) override { return -1; }
+        virtual bool reportsAlarms() const override { return true; }
+};
+
+}
+
+#endif
@@ -0,0 +1,209 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include "LoRaTrafficWheel.h"
+#include "misc/LoRaScalarCollector.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+namespace inet {
+
+Define_Module(LoRaTrafficWheel);
+
+namespace {
+
+// Heap order: earliest time first, then insertion order
+struct ArrivesLater {
+    template<typename T>
+    bool operator()(const T& a, const T& b) const {
+        return a.time > b.time || (a.time == b.time && a.sequence > b.sequence);
+    }
+};
+
+}
+
+LoRaTrafficWheel::~LoRaTrafficWheel()
+{
+    cancelAndDelete(wheelTimer);
+    cancelAndDelete(alarmTimer);
+}
+
+void LoRaTrafficWheel::initialize()
+{
+    slotDuration = par("slotDuration");
+    int numSlots = par("numSlots");
+    if (!(slotDuration > 0) || numSlots <= 0)
+        throw cRuntimeError("LoRaTrafficWheel needs a positive slotDuration and numSlots");
+    slots.resize(numSlots);
+    currentSlot = getSlotIndex(simTime());
+    wheelTimer = new cMessage("wheelTimer");
+
+    alarmMeanInterval = par("alarmMeanInterval");
+    alarmRadius = par("alarmRadius");
+    alarmReportMaxDelay = par("alarmReportMaxDelay");
+    if (alarmMeanInterval > 0) {
+        alarmTimer = new cMessage("alarmTimer");
+        scheduleAt(simTime() + par("alarmStartTime").doubleValue() + exponential(alarmMeanInterval.dbl()), alarmTimer);
+    }
+
+    WATCH(scheduledArrivals);
+    WATCH(dispatchedArrivals);
+    WATCH(arrivalsInSlots);
+    WATCH(alarmEvents);
+}
+
+void LoRaTrafficWheel::handleMessage(cMessage *msg)
+{
+    if (msg == wheelTimer) {
+        dispatchDueArrivals();
+        updateWheelTimer();
+    }
+    else if (msg == alarmTimer) {
+        raiseAlarm();
+        scheduleAt(simTime() + exponential(alarmMeanInterval.dbl()), alarmTimer);
+    }
+    else
+        throw cRuntimeError("Unexpected message %s", msg->getName());
+}
+
+void LoRaTrafficWheel::finish()
+{
+    LoRaScalarCollector::record(this, "scheduledArrivals", scheduledArrivals);
+    LoRaScalarCollector::record(this, "dispatchedArrivals", dispatchedArrivals);
+    LoRaScalarCollector::record(this, "maxPendingArrivals", maxPendingArrivals);
+    LoRaScalarCollector::record(this, "alarmEvents", alarmEvents);
+    LoRaScalarCollector::record(this, "alarmReports", alarmReports);
+}
+
+void LoRaTrafficWheel::scheduleArrival(IClient *client, simtime_t time, int kind)
+{
+    Enter_Method_Silent();
+    if (time < simTime())
+        time = simTime();
+    Arrival arrival = { time, nextSequence++, client, kind };
+    int64_t slot = getSlotIndex(time);
+    if (slot <= currentSlot)
+        pushDueArrival(arrival);
+    else {
+        slots[slot % (int64_t)slots.size()].push_back(arrival);
+        arrivalsInSlots++;
+    }
+    scheduledArrivals++;
+    maxPendingArrivals = std::max(maxPendingArrivals, (long)dueArrivals.size() + arrivalsInSlots);
+    updateWheelTimer();
+}
+
+void LoRaTrafficWheel::registerAlarmClient(IClient *client, const Coord& position)
+{
+    Enter_Method_Silent();
+    alarmClients.push_back({ client, position });
+}
+
+void LoRaTrafficWheel::pushDueArrival(const Arrival& arrival)
+{
+    dueArrivals.push_back(arrival);
+    std::push_heap(dueArrivals.begin(), dueArrivals.end(), ArrivesLater());
+}
+
+void LoRaTrafficWheel::dispatchDueArrivals()
+{
+    while (!dueArrivals.empty() && dueArrivals.front().time <= simTime()) {
+        std::pop_heap(dueArrivals.begin(), dueArrivals.end(), ArrivesLater());
+        Arrival arrival = dueArrivals.back();
+        dueArrivals.pop_back();
+        dispatchedArrivals++;
+        // The client usually schedules its next arrival from here
+        arrival.client->handleTrafficArrival(arrival.kind);
+    }
+}
+
+void LoRaTrafficWheel::advanceToNextArrival()
+{
+    int64_t numSlots = slots.size();
+    int64_t scannedSlots = 0;
+    while (dueArrivals.empty() && arrivalsInSlots > 0) {
+        if (scannedSlots == numSlots) {
+            // Everything left is more than one rotation ahead: jump to the earliest slot
+            int64_t earliestSlot = INT64_MAX;
+            for (const auto& bucket : slots)
+                for (const auto& arrival : bucket)
+                    earliestSlot = std::min(earliestSlot, getSlotIndex(arrival.time));
+            currentSlot = earliestSlot - 1;
+            scannedSlots = 0;
+        }
+        currentSlot++;
+        scannedSlots++;
+        std::vector<Arrival>& bucket = slots[currentSlot % numSlots];
+        for (size_t i = 0; i < bucket.size(); ) {
+            if (getSlotIndex(bucket[i].time) == currentSlot) {
+                pushDueArrival(bucket[i]);
+                bucket[i] = bucket.back();
+                bucket.pop_back();
+                arrivalsInSlots--;
+            }
+            else
+                i++;
+        }
+    }
+}
+
+void LoRaTrafficWheel::updateWheelTimer()
+{
+    if (dueArrivals.empty())
+        advanceToNextArrival();
+    if (dueArrivals.empty()) {
+        cancelEvent(wheelTimer);
+        return;
+    }
+    simtime_t nextArrivalTime = dueArrivals.front().time;
+    if (wheelTimer->isScheduled()) {
+        if (wheelTimer->getArrivalTime() <= nextArrivalTime)
+            return;
+        cancelEvent(wheelTimer);
+    }
+    scheduleAt(nextArrivalTime, wheelTimer);
+}
+
+void LoRaTrafficWheel::raiseAlarm()
+{
+    if (alarmClients.empty())
+        return;
+    Coord min = alarmClients.front().position;
+    Coord max = min;
+    for (const auto& alarmClient : alarmClients) {
+        min.x = std::min(min.x, alarmClient.position.x);
+        min.y = std::min(min.y, alarmClient.position.y);
+        max.x = std::max(max.x, alarmClient.position.x);
+        max.y = std::max(max.y, alarmClient.position.y);
+    }
+    Coord epicentre(uniform(min.x, max.x), uniform(min.y, max.y), 0);
+    long reports = 0;
+    for (const auto& alarmClient : alarmClients) {
+        Coord position = alarmClient.position;
+        position.z = 0;
+        if (position.distance(epicentre) <= alarmRadius) {
+            scheduleArrival(alarmClient.client, simTime() + uniform(0, alarmReportMaxDelay.dbl()), ALARM_REPORT);
+            reports++;
+        }
+    }
+    alarmEvents++;
+    alarmReports += reports;
+    EV_INFO << "Alarm " << alarmEvents << " at (" << epicentre.x << ", " << epicentre.y << "): "
+            << reports << " nodes within " << alarmRadius << " m report it" << endl;
+}
+
+}
@@ -0,0 +1,117 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#ifndef __LORA_OMNET_LORATRAFFICWHEEL_H_
+#define __LORA_OMNET_LORATRAFFICWHEEL_H_
+
+#include <omnetpp.h>
+#include <cstdint>
+#include <vector>
+
+#include "inet/common/geometry/common/Coord.h"
+
+using namespace omnetpp;
+
+namespace inet {
+
+/**
+ * Shared hashed timing wheel for the data arrivals of all nodes. Arrivals are
+ * bucketed by slot; only the current slot is kept sorted, and a single timer
+ * fires at the earliest pending arrival. This replaces one scheduled
+ * self-message per node per packet with O(1) inserts and one FES entry.
+ *
+ * The wheel also raises alarm events: each picks a random epicentre within
+ * the area covered by the registered alarm clients and schedules a report,
+ * jittered by up to alarmReportMaxDelay, for every client within alarmRadius.
+ */
+class INET_API LoRaTrafficWheel : public cSimpleModule
+{
+    public:
+        enum ArrivalKind {
+            TRAFFIC_ARRIVAL = 0,
+            ALARM_REPORT = 1
+        };
+
+        /**
+         * Receives the arrivals scheduled on the wheel, as a direct method call.
+         */
+        class IClient
+        {
+            public:
+                virtual ~IClient() {}
+                virtual void handleTrafficArrival(int kind) = 0;
+        };
+
+    protected:
+        struct Arrival {
+            simtime_t time;
+            uint64_t sequence;  // insertion order, breaks ties deterministically
+            IClient *client;
+            int kind;
+        };
+        struct AlarmClient {
+            IClient *client;
+            Coord position;
+        };
+
+        simtime_t slotDuration;
+        std::vector<std::vector<Arrival>> slots;
+        // Arrivals of slots up to currentSlot, as a min-heap on (time, sequence)
+        std::vector<Arrival> dueArrivals;
+        int64_t currentSlot = 0;
+        long arrivalsInSlots = 0;
+        uint64_t nextSequence = 0;
+        cMessage *wheelTimer = nullptr;
+
+        simtime_t alarmMeanInterval;
+        double alarmRadius;
+        simtime_t alarmReportMaxDelay;
+        cMessage *alarmTimer = nullptr;
+        std::vector<AlarmClient> alarmClients;
+
+        long scheduledArrivals = 0;
+        long dispatchedArrivals = 0;
+        long maxPendingArrivals = 0;
+        long alarmEvents = 0;
+        long alarmReports = 0;
+
+    protected:
+        virtual void initialize() override;
+        virtual void handleMessage(cMessage *msg) override;
+        virtual void finish() override;
+
+        int64_t getSlotIndex(simtime_t time) const { return (int64_t)floor(time.dbl() / slotDuration.dbl()); }
+        void pushDueArrival(const Arrival& arrival);
+        void dispatchDueArrivals();
+        void advanceToNextArrival();
+        void updateWheelTimer();
+        void raiseAlarm();
+
+    public:
+        virtual ~LoRaTrafficWheel();
+
+        /**
+         * Schedules an arrival for the client at the given time (clamped to now).
+         */
+        void scheduleArrival(IClient *client, simtime_t time, int kind = TRAFFIC_ARRIVAL);
+        /**
+         * Registers a client that reports the alarm events around its position.
+         */
+        void registerAlarmClient(IClient *client, const Coord& position);
+};
+
+}
+
+#endif
@@ -14,6 +14,7 @@
 // 
 
 #include "LoRaEnergyConsumer.h"
+#include "misc/LoRaScalarCollector.h"
 
 #include "inet/physicallayer/contract/packetlevel/IRadio.h"
 #include "LoRaPhy/LoRaTransmitter.h"
@@ -71,7 +72,7 @@ void LoRaEnergyConsumer::initialize(int stage)
 
 void LoRaEnergyConsumer::finish()
 {
-    recordScalar("totalEnergyConsumed", double(totalEnergyConsumed));
+    LoRaScalarCollector::record(this, "totalEnergyConsumed", double(totalEnergyConsumed));
 }
 
 bool LoRaEnergyConsumer::readConfigurationFile()
@@ -14,6 +14,7 @@
 // 
 
 #include "LoRaHataOkumura.h"
+#include "LoRaLinkBudget.h"
 
 namespace inet {
 
@@ -43,7 +44,7 @@ std::ostream& LoRaHataOkumura::printToStream(std::ostream& stream, int level) co
 double LoRaHataOkumura::computePathLoss(mps propagationSpeed, Hz frequency, m distance) const
 {
     // build based on documentation from Actility
-    double PL_db = K1 + K2 * log10(distance.get()/1000);
+    double PL_db = linkbudget::hataOkumuraPathLossDb(distance.get(), K1, K2);
     return math::dB2fraction(-PL_db);
 }
 
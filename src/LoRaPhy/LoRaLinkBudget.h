@@ -0,0 +1,95 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#ifndef LORAPHY_LORALINKBUDGET_H_
+#define LORAPHY_LORALINKBUDGET_H_
+
+#include <cmath>
+#include <limits>
+
+// Plain link-budget formulas shared by the path loss models, LoRaReceiver and the standalone
+// tools/linkbudget planner. Deliberately free of OMNeT++/INET types so it builds without them.
+// All path losses are the deterministic (mean) part in dB; shadowing is added by the callers.
+
+namespace inet {
+
+namespace physicallayer {
+
+namespace linkbudget {
+
+// "Do LoRa Low-Power Wide-Area Networks Scale?" log-distance model, PL(d0) = 96 dB
+const double LOG_NORMAL_PL_D0_DB = 96;
+
+inline double logNormalShadowingPathLossDb(double distance, double d0, double gamma)
+{
+    return LOG_NORMAL_PL_D0_DB + 10 * gamma * std::log10(distance / d0);
+}
+
+inline double logNormalShadowingRange(double maxPathLossDb, double d0, double gamma)
+{
+    return d0 * std::pow(10, (maxPathLossDb - LOG_NORMAL_PL_D0_DB) / (10 * gamma));
+}
+
+// Oulu measurements: EPL = B + 10 n log10(d / d0) - antenna gain
+inline double ouluPathLossDb(double distance, double d0, double n, double B, double antennaGain)
+{
+    return B + 10 * n * std::log10(distance / d0) - antennaGain;
+}
+
+inline double ouluRange(double maxPathLossDb, double d0, double n, double B, double antennaGain)
+{
+    return d0 * std::pow(10, (maxPathLossDb - B + antennaGain) / (10 * n));
+}
+
+// Hata-Okumura as documented by Actility, distance in m
+inline double hataOkumuraPathLossDb(double distance, double K1, double K2)
+{
+    return K1 + K2 * std::log10(distance / 1000);
+}
+
+inline double hataOkumuraRange(double maxPathLossDb, double K1, double K2)
+{
+    return 1000 * std::pow(10, (maxPathLossDb - K1) / K2);
+}
+
+/**
+ * Receiver sensitivity in dBm from the Semtech SX1272/73 datasheet, table 10,
+ * Rev 3.1, March 2017. Returns NaN for SF/BW combinations not in the table.
+ */
+inline double loRaSensitivityDbm(int sf, double bandwidthHz)
+{
+    static const double table[7][3] = {
+        // 125 kHz, 250 kHz, 500 kHz
+        { -121, -118, -111 },   // SF6
+        { -124, -122, -116 },   // SF7
+        { -127, -125, -119 },   // SF8
+        { -130, -128, -122 },   // SF9
+        { -133, -130, -125 },   // SF10
+        { -135, -132, -128 },   // SF11
+        { -137, -135, -129 },   // SF12
+    };
+    int bwIndex = bandwidthHz == 125000 ? 0 : bandwidthHz == 250000 ? 1 : bandwidthHz == 500000 ? 2 : -1;
+    if (sf < 6 || sf > 12 || bwIndex < 0)
+        return std::numeric_limits<double>::quiet_NaN();
+    return table[sf - 6][bwIndex];
+}
+
+} // namespace linkbudget
+
+} // namespace physicallayer
+
+} // namespace inet
+
+#endif /* LORAPHY_LORALINKBUDGET_H_ */
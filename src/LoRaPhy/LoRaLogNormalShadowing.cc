@@ -15,6 +15,7 @@
 
 #include "LoRaLogNormalShadowing.h"
 #include "inet/common/INETMath.h"
+#include "LoRaLinkBudget.h"
 
 namespace inet {
 
@@ -51,21 +52,17 @@ std::ostream& LoRaLogNormalShadowing::printToStream(std::ostream& stream, int le
 double LoRaLogNormalShadowing::computePathLoss(mps propagationSpeed, Hz frequency, m distance) const
 {
     // parameters taken from paper "Do LoRa Low-Power Wide-Area Networks Scale?"
-    double PL_d0_db = 96;
-    double PL_db = PL_d0_db + 10 * gamma * log10(unit(distance / d0).get()) + normal(0.0, sigma);
+    double PL_db = linkbudget::logNormalShadowingPathLossDb(distance.get(), d0.get(), gamma) + normal(0.0, sigma);
     return math::dB2fraction(-PL_db);
 }
 
 m LoRaLogNormalShadowing::computeRange(W transmissionPower) const
 {
     // parameters taken from paper "Do LoRa Low-Power Wide-Area Networks Scale?"
-    double PL_d0_db = 96;
     double max_sensitivity = -137;
     double trans_power_db = round(10 * log10(transmissionPower.get()*1000));
     EV << "LoRaLogNormalShadowing transmissionPower in W = " << transmissionPower << " in dBm = " << trans_power_db << endl;
-    double rhs = (trans_power_db - PL_d0_db - max_sensitivity)/(10 * gamma);
-    double distance = d0.get() * pow(10, rhs);
-    return m(distance);
+    return m(linkbudget::logNormalShadowingRange(trans_power_db - max_sensitivity, d0.get(), gamma));
 }
 
 
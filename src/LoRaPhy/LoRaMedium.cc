@@ -13,6 +13,7 @@
 // along with this program.  If not, see http://www.gnu.org/licenses/.
 // 
 #include "LoRaMedium.h"
+#include "misc/LoRaScalarCollector.h"
 #include "inet/common/INETUtils.h"
 #include "inet/common/ModuleAccess.h"
 #include "inet/common/NotifierConsts.h"
@@ -21,6 +22,14 @@
 #include "inet/physicallayer/common/packetlevel/Interference.h"
 #include "inet/physicallayer/common/packetlevel/Radio.h"
 #include "inet/physicallayer/common/packetlevel/RadioMedium.h"
+#include "LoRaReceiver.h"
+#include "LoRaReception.h"
+#include "LoRaTransmission.h"
+#include "LoRaBandListening.h"
+#include "LoRa/LoRaMac.h"
+#include "LoRa/LoRaGWRadio.h"
+#include "LoRa/LoRaMotoGWRadio.h"
+#include <cmath>
 namespace inet {
 namespace physicallayer {
 Define_Module(LoRaMedium);
@@ -64,6 +73,8 @@ LoRaMedium::LoRaMedium() :
 LoRaMedium::~LoRaMedium()
 {
     cancelAndDelete(removeNonInterferingTransmissionsTimer);
+    for (auto& entry : fastModeTransmissions)
+        cancelAndDelete(entry.second.endTimer);
     for (const auto transmission : transmissions) {
         delete communicationCache->getCachedFrame(transmission);
         delete transmission;
@@ -97,6 +108,12 @@ void LoRaMedium::initialize(int stage)
         radioModeFilter = par("radioModeFilter");
         listeningFilter = par("listeningFilter");
         macAddressFilter = par("macAddressFilter");
+        fastMode = hasPar("fastMode") && par("fastMode").boolValue();
+        if (fastMode) {
+            fastModeAnalogModel = dynamic_cast<const LoRaAnalogModel *>(analogModel);
+            if (fastModeAnalogModel == nullptr)
+                throw cRuntimeError("fastMode requires LoRaAnalogModel as analogModelType");
+        }
         // initialize timers
         removeNonInterferingTransmissionsTimer = new cMessage("removeNonInterferingTransmissions");
         // initialize logging
@@ -127,18 +144,25 @@ void LoRaMedium::finish()
     EV_INFO << "SNIR cache hit = " << snirCacheHitPercentage << " %" << endl;
     EV_INFO << "Reception decision cache hit = " << decisionCacheHitPercentage << " %" << endl;
     EV_INFO << "Reception result cache hit = " << resultCacheHitPercentage << " %" << endl;
-    recordScalar("transmission count", transmissionCount);
-    recordScalar("radio frame send count", radioFrameSendCount);
-    recordScalar("reception computation count", receptionComputationCount);
-    recordScalar("interference computation count", interferenceComputationCount);
-    recordScalar("reception decision computation count", receptionDecisionComputationCount);
-    recordScalar("listening decision computation count", listeningDecisionComputationCount);
-    recordScalar("reception cache hit", receptionCacheHitPercentage, "%");
-    recordScalar("interference cache hit", interferenceCacheHitPercentage, "%");
-    recordScalar("noise cache hit", noiseCacheHitPercentage, "%");
-    recordScalar("snir cache hit", snirCacheHitPercentage, "%");
-    recordScalar("reception decision cache hit", decisionCacheHitPercentage, "%");
-    recordScalar("reception result cache hit", resultCacheHitPercentage, "%");
+    LoRaScalarCollector::record(this, "transmission count", transmissionCount);
+    LoRaScalarCollector::record(this, "radio frame send count", radioFrameSendCount);
+    LoRaScalarCollector::record(this, "reception computation count", receptionComputationCount);
+    LoRaScalarCollector::record(this, "interference computation count", interferenceComputationCount);
+    LoRaScalarCollector::record(this, "reception decision computation count", receptionDecisionComputationCount);
+    LoRaScalarCollector::record(this, "listening decision computation count", listeningDecisionComputationCount);
+    LoRaScalarCollector::record(this, "reception cache hit", receptionCacheHitPercentage, "%");
+    LoRaScalarCollector::record(this, "interference cache hit", interferenceCacheHitPercentage, "%");
+    LoRaScalarCollector::record(this, "noise cache hit", noiseCacheHitPercentage, "%");
+    LoRaScalarCollector::record(this, "snir cache hit", snirCacheHitPercentage, "%");
+    LoRaScalarCollector::record(this, "reception decision cache hit", decisionCacheHitPercentage, "%");
+    LoRaScalarCollector::record(this, "reception result cache hit", resultCacheHitPercentage, "%");
+    LoRaScalarCollector::record(this, "other band reception skip count", otherBandReceptionSkipCount);
+    LoRaScalarCollector::record(this, "incompatible reception skip count", incompatibleReceptionSkipCount);
+    if (fastMode) {
+        LoRaScalarCollector::record(this, "fast mode skipped frame count", fastModeSkippedFrameCount);
+        LoRaScalarCollector::record(this, "fast mode collided frame count", fastModeCollidedFrameCount);
+        LoRaScalarCollector::record(this, "fast mode delivered frame count", fastModeDeliveredFrameCount);
+    }
 }
 std::ostream& LoRaMedium::printToStream(std::ostream &stream, int level) const
 {
@@ -159,19 +183,62 @@ void LoRaMedium::handleMessage(cMessage *message)
 {
     if (message == removeNonInterferingTransmissionsTimer)
         removeNonInterferingTransmissions();
+    else if (fastMode && !strcmp(message->getName(), "fastModeTransmissionEnd"))
+        endFastModeTransmission(message);
     else
         throw cRuntimeError("Unknown message");
 }
-bool LoRaMedium::isRadioMacAddress(const IRadio *radio, const MACAddress address) const
-{
-    cModule *host = getContainingNode(const_cast<cModule *>(check_and_cast<const cModule *>(radio)));
-    IInterfaceTable *interfaceTable = check_and_cast<IInterfaceTable *>(host->getSubmodule("interfaceTable"));
-    for (int i = 0; i < interfaceTable->getNumInterfaces(); i++) {
-        const InterfaceEntry *interface = interfaceTable->getInterface(i);
-        if (interface && interface->getMacAddress() == address)
-            return true;
+void LoRaMedium::updateAddressMaps() const
+{
+    devAddrToRadios.clear();
+    macAddressToRadios.clear();
+    for (const auto radio : radios) {
+        if (radio == nullptr)
+            continue;
+        cModule *radioModule = const_cast<cModule *>(check_and_cast<const cModule *>(radio));
+        LoRaMac *loRaMac = dynamic_cast<LoRaMac *>(radioModule->getParentModule()->getSubmodule("mac"));
+        if (loRaMac != nullptr)
+            devAddrToRadios[loRaMac->getAddress().getInt()].push_back(radio);
+        cModule *host = getContainingNode(radioModule);
+        IInterfaceTable *interfaceTable = dynamic_cast<IInterfaceTable *>(host->getSubmodule("interfaceTable"));
+        if (interfaceTable == nullptr)
+            continue;
+        for (int i = 0; i < interfaceTable->getNumInterfaces(); i++) {
+            const InterfaceEntry *interface = interfaceTable->getInterface(i);
+            if (interface && !interface->getMacAddress().isUnspecified())
+                macAddressToRadios[interface->getMacAddress().getInt()].push_back(radio);
+        }
     }
-    return false;
+    addressMapsValid = true;
+}
+const std::vector<const IRadio *> *LoRaMedium::getAddressedRadios(const ITransmission *transmission) const
+{
+    static const std::vector<const IRadio *> noRadios;
+    if (!addressMapsValid)
+        updateAddressMaps();
+    const cPacket *macFrame = transmission->getMacFrame();
+    const std::unordered_map<uint64, std::vector<const IRadio *>> *addressMap;
+    uint64 address;
+    if (const LoRaMacFrame *loRaMacFrame = dynamic_cast<const LoRaMacFrame *>(macFrame)) {
+        if (loRaMacFrame->getReceiverAddress().isBroadcast())
+            return nullptr;
+        addressMap = &devAddrToRadios;
+        address = loRaMacFrame->getReceiverAddress().getInt();
+    }
+    else {
+        const MACAddress receiverAddress = check_and_cast<const IMACFrame *>(macFrame)->getReceiverAddress();
+        if (receiverAddress.isMulticast())
+            return nullptr;
+        addressMap = &macAddressToRadios;
+        address = receiverAddress.getInt();
+    }
+    auto it = addressMap->find(address);
+    return it != addressMap->end() ? &it->second : &noRadios;
+}
+bool LoRaMedium::isAddressedRadio(const IRadio *radio, const ITransmission *transmission) const
+{
+    const std::vector<const IRadio *> *addressedRadios = getAddressedRadios(transmission);
+    return addressedRadios == nullptr || std::find(addressedRadios->begin(), addressedRadios->end(), radio) != addressedRadios->end();
 }
 bool LoRaMedium::isInCommunicationRange(const ITransmission *transmission, const Coord startPosition, const Coord endPosition) const
 {
@@ -209,6 +276,17 @@ bool LoRaMedium::isInterferingTransmission(const ITransmission *transmission, co
            arrival->getStartTime() < reception->getEndTime() - minInterferenceTime &&
            isInInterferenceRange(transmission, reception->getStartPosition(), reception->getEndPosition());
 }
+bool LoRaMedium::isInLoRaBand(const ITransmission *transmission, Hz carrierFrequency, Hz bandwidth) const
+{
+    const LoRaTransmission *loRaTransmission = dynamic_cast<const LoRaTransmission *>(transmission);
+    if (loRaTransmission == nullptr)
+        return true;
+    // Partially overlapping bands are kept so that LoRaAnalogModel still rejects them
+    bool inBand = std::abs((loRaTransmission->getLoRaCF() - carrierFrequency).get()) < (loRaTransmission->getLoRaBW() + bandwidth).get() / 2;
+    if (!inBand)
+        otherBandReceptionSkipCount++;
+    return inBand;
+}
 void LoRaMedium::removeNonInterferingTransmissions()
 {
     const simtime_t now = simTime();
@@ -221,6 +299,8 @@ void LoRaMedium::removeNonInterferingTransmissions()
         const IRadioFrame *radioFrame = communicationCache->getCachedFrame(transmission);
         communicationCache->removeCachedFrame(transmission);
         communicationCache->removeTransmission(transmission);
+        if (fastMode)
+            fastModeTransmissions.erase(transmission->getId());
         emit(transmissionRemovedSignal, check_and_cast<const cObject *>(transmission));
         delete radioFrame;
         delete transmission;
@@ -234,10 +314,11 @@ void LoRaMedium::removeNonInterferingTransmissions()
 const std::vector<const IReception *> *LoRaMedium::computeInterferingReceptions(const IListening *listening, const std::vector<const ITransmission *> *transmissions) const
 {
     const IRadio *radio = listening->getReceiver();
+    const LoRaBandListening *bandListening = check_and_cast<const LoRaBandListening *>(listening);
     std::vector<const ITransmission *> *interferingTransmissions = communicationCache->computeInterferingTransmissions(radio, listening->getStartTime(), listening->getEndTime());
     std::vector<const IReception *> *interferingReceptions = new std::vector<const IReception *>();
     for (const auto interferingTransmission : *interferingTransmissions)
-        if (isInterferingTransmission(interferingTransmission, listening))
+        if (isInterferingTransmission(interferingTransmission, listening) && isInLoRaBand(interferingTransmission, bandListening->getLoRaCF(), bandListening->getLoRaBW()))
             interferingReceptions->push_back(getReception(radio, interferingTransmission));
     delete interferingTransmissions;
     return interferingReceptions;
@@ -247,10 +328,11 @@ const std::vector<const IReception *> *LoRaMedium::computeInterferingReceptions(
 {
     const IRadio *radio = reception->getReceiver();
     const ITransmission *transmission = reception->getTransmission();
+    const LoRaReception *loRaReception = check_and_cast<const LoRaReception *>(reception);
     std::vector<const ITransmission *> *interferingTransmissions = communicationCache->computeInterferingTransmissions(radio, reception->getStartTime(), reception->getEndTime());
     std::vector<const IReception *> *interferingReceptions = new std::vector<const IReception *>();
     for (const auto interferingTransmission : *interferingTransmissions)
-        if (transmission != interferingTransmission && isInterferingTransmission(interferingTransmission, reception))
+        if (transmission != interferingTransmission && isInterferingTransmission(interferingTransmission, reception) && isInLoRaBand(interferingTransmission, loRaReception->getLoRaCF(), loRaReception->getLoRaBW()))
             interferingReceptions->push_back(getReception(radio, interferingTransmission));
     delete interferingTransmissions;
     return interferingReceptions;
@@ -393,6 +475,7 @@ const IReceptionResult *LoRaMedium::getReceptionResult(const IRadio *radio, cons
 void LoRaMedium::addRadio(const IRadio *radio)
 {
     radios.push_back(radio);
+    addressMapsValid = false;
     communicationCache->addRadio(radio);
     if (neighborCache)
         neighborCache->addRadio(radio);
@@ -418,12 +501,13 @@ void LoRaMedium::removeRadio(const IRadio *radio)
     int radioIndex = radio->getId() - radios[0]->getId();
     radios[radioIndex] = nullptr;
     int radioCount = 0;
-    while (radios[radioCount] == nullptr && radioCount < (int)radios.size())
+    while (radioCount < (int)radios.size() && radios[radioCount] == nullptr)
         radioCount++;
     if (radioCount != 0)
         radios.erase(radios.begin(), radios.begin() + radioCount);
+    addressMapsValid = false;
     communicationCache->removeRadio(radio);
-    if (neighborCache)
+    if (neighborCache && detachedRadios.erase(radio) == 0)
         neighborCache->removeRadio(radio);
     mediumLimitCache->removeRadio(radio);
     cModule *radioModule = const_cast<cModule *>(check_and_cast<const cModule *>(radio));
@@ -436,6 +520,38 @@ void LoRaMedium::removeRadio(const IRadio *radio)
     emit(radioRemovedSignal, radioModule);
 }
 
+void LoRaMedium::detachRadio(const IRadio *radio)
+{
+    Enter_Method_Silent();
+    if (!detachedRadios.insert(radio).second)
+        return;
+    EV_INFO << "Detaching " << radio << " from the medium" << endl;
+    if (neighborCache)
+        neighborCache->removeRadio(radio);
+}
+
+void LoRaMedium::attachRadio(const IRadio *radio)
+{
+    Enter_Method_Silent();
+    if (detachedRadios.erase(radio) == 0)
+        return;
+    EV_INFO << "Attaching " << radio << " to the medium" << endl;
+    // Frames of the ongoing transmissions are not delivered any more, but
+    // they still interfere with what the radio receives from now on
+    for (const auto transmission : transmissions) {
+        if (communicationCache->getCachedArrival(radio, transmission) != nullptr)
+            continue;
+        const IArrival *arrival = propagation->computeArrival(transmission, radio->getAntenna()->getMobility());
+        const Interval *interval = new Interval(arrival->getStartTime(), arrival->getEndTime(), (void *)transmission);
+        const IListening *listening = radio->getReceiver()->createListening(radio, arrival->getStartTime(), arrival->getEndTime(), arrival->getStartPosition(), arrival->getEndPosition());
+        communicationCache->setCachedArrival(radio, transmission, arrival);
+        communicationCache->setCachedInterval(radio, transmission, interval);
+        communicationCache->setCachedListening(radio, transmission, listening);
+    }
+    if (neighborCache)
+        neighborCache->addRadio(radio);
+}
+
 void LoRaMedium::addTransmission(const IRadio *transmitterRadio, const ITransmission *transmission)
 {
     transmissionCount++;
@@ -443,7 +559,7 @@ void LoRaMedium::addTransmission(const IRadio *transmitterRadio, const ITransmis
     communicationCache->addTransmission(transmission);
     simtime_t maxArrivalEndTime = transmission->getEndTime();
     for (const auto receiverRadio : radios) {
-        if (receiverRadio != nullptr && receiverRadio != transmitterRadio) {
+        if (receiverRadio != nullptr && receiverRadio != transmitterRadio && !isRadioDetached(receiverRadio)) {
             const IArrival *arrival = propagation->computeArrival(transmission, receiverRadio->getAntenna()->getMobility());
             const Interval *interval = new Interval(arrival->getStartTime(), arrival->getEndTime(), (void *)transmission);
             const IListening *listening = receiverRadio->getReceiver()->createListening(receiverRadio, arrival->getStartTime(), arrival->getEndTime(), arrival->getStartPosition(), arrival->getEndPosition());
@@ -517,7 +633,7 @@ void LoRaMedium::sendToRadio(IRadio *transmitter, const IRadio *receiver, const
     const Radio *transmitterRadio = check_and_cast<const Radio *>(transmitter);
     const Radio *receiverRadio = check_and_cast<const Radio *>(receiver);
     const ITransmission *transmission = frame->getTransmission();
-    if (receiverRadio != transmitterRadio && isPotentialReceiver(receiverRadio, transmission)) {
+    if (receiverRadio != transmitterRadio && !isRadioDetached(receiverRadio) && isPotentialReceiver(receiverRadio, transmission)) {
         const IArrival *arrival = getArrival(receiverRadio, transmission);
         simtime_t propagationTime = arrival->getStartPropagationTime();
         EV_DEBUG << "Sending " << frame
@@ -539,7 +655,10 @@ IRadioFrame *LoRaMedium::transmitPacket(const IRadio *radio, cPacket *macFrame)
     addTransmission(radio, transmission);
     if (recordCommunicationLog)
         communicationLog.writeTransmission(radio, radioFrame);
-    sendToAffectedRadios(const_cast<IRadio *>(radio), radioFrame);
+    if (fastMode)
+        addFastModeTransmission(radio, transmission);
+    else
+        sendToAffectedRadios(const_cast<IRadio *>(radio), radioFrame);
     communicationCache->setCachedFrame(transmission, radioFrame);
     return radioFrame;
 }
@@ -558,7 +677,7 @@ cPacket *LoRaMedium::receivePacket(const IRadio *radio, IRadioFrame *radioFrame)
 }
 const IListeningDecision *LoRaMedium::listenOnMedium(const IRadio *radio, const IListening *listening) const
 {
-    const IListeningDecision *decision = computeListeningDecision(radio, listening, const_cast<const std::vector<const ITransmission *> *>(&transmissions));
+    const IListeningDecision *decision = fastMode ? computeFastModeListeningDecision(radio, listening) : computeListeningDecision(radio, listening, const_cast<const std::vector<const ITransmission *> *>(&transmissions));
     EV_DEBUG << "Listening with " << listening << " on medium by " << radio << " results in " << decision << endl;
     return decision;
 }
@@ -569,7 +688,7 @@ bool LoRaMedium::isPotentialReceiver(const IRadio *radio, const ITransmission *t
         return false;
     else if (listeningFilter && !radio->getReceiver()->computeIsReceptionPossible(getListening(radio, transmission), transmission))
         return false;
-    else if (macAddressFilter && !isRadioMacAddress(radio, check_and_cast<const IMACFrame *>(transmission->getMacFrame())->getReceiverAddress()))
+    else if (macAddressFilter && !isAddressedRadio(radio, transmission))
         return false;
     else if (rangeFilter == RANGE_FILTER_INTERFERENCE_RANGE) {
         const IArrival *arrival = getArrival(radio, transmission);
@@ -582,10 +701,20 @@ bool LoRaMedium::isPotentialReceiver(const IRadio *radio, const ITransmission *t
     else
         return true;
 }
+bool LoRaMedium::isCompatibleTransmission(const IRadio *receiver, const IListening *listening, const ITransmission *transmission) const
+{
+    const LoRaReceiver *loRaReceiver = dynamic_cast<const LoRaReceiver *>(receiver->getReceiver());
+    if (loRaReceiver == nullptr || loRaReceiver->isTransmissionCompatible(listening, transmission))
+        return true;
+    incompatibleReceptionSkipCount++;
+    return false;
+}
 bool LoRaMedium::isReceptionPossible(const IRadio *receiver, const ITransmission *transmission, IRadioSignal::SignalPart part) const
 {
-    const IReception *reception = getReception(receiver, transmission);
     const IListening *listening = getListening(receiver, transmission);
+    if (!isCompatibleTransmission(receiver, listening, transmission))
+        return false;
+    const IReception *reception = getReception(receiver, transmission);
     // TODO: why compute?
     const IInterference *interference = computeInterference(receiver, listening, transmission, const_cast<const std::vector<const ITransmission *> *>(&transmissions));
     bool isReceptionPossible = receiver->getReceiver()->computeIsReceptionAttempted(listening, reception, part, interference);
@@ -594,8 +723,10 @@ bool LoRaMedium::isReceptionPossible(const IRadio *receiver, const ITransmission
 }
 bool LoRaMedium::isReceptionAttempted(const IRadio *receiver, const ITransmission *transmission, IRadioSignal::SignalPart part) const
 {
-    const IReception *reception = getReception(receiver, transmission);
     const IListening *listening = getListening(receiver, transmission);
+    if (!isCompatibleTransmission(receiver, listening, transmission))
+        return false;
+    const IReception *reception = getReception(receiver, transmission);
     // TODO: why compute?
     const IInterference *interference = computeInterference(receiver, listening, transmission, const_cast<const std::vector<const ITransmission *> *>(&transmissions));
     bool isReceptionAttempted = receiver->getReceiver()->computeIsReceptionAttempted(listening, reception, part, interference);
@@ -613,6 +744,158 @@ bool LoRaMedium::isReceptionSuccessful(const IRadio *receiver, const ITransmissi
     delete interference;
     return isReceptionSuccessful;
 }
+void LoRaMedium::addFastModeTransmission(const IRadio *transmitterRadio, const ITransmission *transmission)
+{
+    Enter_Method_Silent();
+    const LoRaTransmission *loRaTransmission = check_and_cast<const LoRaTransmission *>(transmission);
+    FastModeTransmission& entry = fastModeTransmissions[transmission->getId()];
+    entry.transmission = transmission;
+    entry.carrierFrequency = loRaTransmission->getLoRaCF();
+    entry.bandwidth = loRaTransmission->getLoRaBW();
+    entry.spreadingFactor = loRaTransmission->getLoRaSF();
+    simtime_t maxArrivalEndTime = transmission->getEndTime();
+    for (const auto receiverRadio : radios) {
+        if (receiverRadio == nullptr || receiverRadio == transmitterRadio || isRadioDetached(receiverRadio))
+            continue;
+        // As with radio frames, only a receiver that listens when the frame starts can receive it
+        IRadio::RadioMode radioMode = receiverRadio->getRadioMode();
+        if (radioMode != IRadio::RADIO_MODE_RECEIVER && radioMode != IRadio::RADIO_MODE_TRANSCEIVER)
+            continue;
+        if (!isCompatibleTransmission(receiverRadio, getListening(receiverRadio, transmission), transmission))
+            continue;
+        if (macAddressFilter && !isAddressedRadio(receiverRadio, transmission))
+            continue;
+        entry.receivers.push_back(receiverRadio);
+        const simtime_t arrivalEndTime = getArrival(receiverRadio, transmission)->getEndTime();
+        if (arrivalEndTime > maxArrivalEndTime)
+            maxArrivalEndTime = arrivalEndTime;
+    }
+    entry.endTimer = new cMessage("fastModeTransmissionEnd");
+    entry.endTimer->setContextPointer(const_cast<ITransmission *>(transmission));
+    scheduleAt(maxArrivalEndTime, entry.endTimer);
+}
+void LoRaMedium::endFastModeTransmission(cMessage *timer)
+{
+    const ITransmission *transmission = static_cast<const ITransmission *>(timer->getContextPointer());
+    FastModeTransmission& entry = fastModeTransmissions.at(transmission->getId());
+    entry.endTimer = nullptr;
+    delete timer;
+    for (const auto receiverRadio : entry.receivers) {
+        IRadio::RadioMode radioMode = receiverRadio->getRadioMode();
+        if (isRadioDetached(receiverRadio) || (radioMode != IRadio::RADIO_MODE_RECEIVER && radioMode != IRadio::RADIO_MODE_TRANSCEIVER))
+            continue;
+        const LoRaReceiver *loRaReceiver = check_and_cast<const LoRaReceiver *>(receiverRadio->getReceiver());
+        W receptionPower = getFastModeReceptionPower(entry, receiverRadio);
+        if (receptionPower < loRaReceiver->getSensitivity(entry.spreadingFactor, entry.bandwidth)) {
+            fastModeSkippedFrameCount++;
+            continue;
+        }
+        if (isFastModeReceptionCollided(entry, receiverRadio, receptionPower)) {
+            fastModeCollidedFrameCount++;
+            continue;
+        }
+        EV_DEBUG << "Fast mode delivers " << transmission->getMacFrame() << " to " << receiverRadio << " at " << receptionPower << endl;
+        cPacket *macFrame = transmission->getMacFrame()->dup();
+        ReceptionIndication *indication = new ReceptionIndication();
+        indication->setMinRSSI(receptionPower);
+        indication->setMinSNIR(computeFastModeSNIR(entry, receiverRadio, receptionPower));
+        macFrame->setControlInfo(indication);
+        // Same value LoRaRadio::endReception parses out of the reception
+        cMsgPar *rssi = new cMsgPar("rssi");
+        rssi->setDoubleValue(math::mW2dBm(receptionPower.get()));
+        macFrame->addObject(rssi);
+        drop(macFrame);
+        IRadio *radio = const_cast<IRadio *>(receiverRadio);
+        if (LoRaRadio *loRaRadio = dynamic_cast<LoRaRadio *>(radio))
+            loRaRadio->receiveFastModeFrame(macFrame);
+        else if (LoRaGWRadio *loRaGWRadio = dynamic_cast<LoRaGWRadio *>(radio))
+            loRaGWRadio->receiveFastModeFrame(macFrame);
+        else
+            check_and_cast<LoRaMotoGWRadio *>(radio)->receiveFastModeFrame(macFrame);
+        fastModeDeliveredFrameCount++;
+    }
+}
+W LoRaMedium::getFastModeReceptionPower(const FastModeTransmission& entry, const IRadio *receiver) const
+{
+    auto it = entry.receptionPowers.find(receiver->getId());
+    if (it != entry.receptionPowers.end())
+        return it->second;
+    W receptionPower = fastModeAnalogModel->computeReceptionPower(receiver, entry.transmission, getArrival(receiver, entry.transmission));
+    entry.receptionPowers[receiver->getId()] = receptionPower;
+    return receptionPower;
+}
+bool LoRaMedium::isFastModeReceptionCollided(const FastModeTransmission& entry, const IRadio *receiver, W receptionPower) const
+{
+    const LoRaReceiver *loRaReceiver = check_and_cast<const LoRaReceiver *>(receiver->getReceiver());
+    const IArrival *arrival = getArrival(receiver, entry.transmission);
+    simtime_t m_x = (arrival->getStartTime() + arrival->getEndTime()) / 2;
+    simtime_t d_x = (arrival->getEndTime() - arrival->getStartTime()) / 2;
+    // The first preamble symbols may be hit without losing the frame, as in LoRaReceiver::isPacketCollided
+    simtime_t Tsym = (pow(2, entry.spreadingFactor)) / (entry.bandwidth.get() / 1000) / 1000;
+    simtime_t csBegin = arrival->getStartTime() + Tsym * (8 - 5);
+    double receptionPowerDbm = math::mW2dBm(mW(receptionPower).get());
+    for (const auto transmission : transmissions) {
+        if (transmission == entry.transmission)
+            continue;
+        if (transmission->getTransmitter() == receiver) {
+            // Half duplex: the receiver transmitted while the frame arrived
+            if (transmission->getStartTime() < arrival->getEndTime() && transmission->getEndTime() > arrival->getStartTime())
+                return true;
+            continue;
+        }
+        const FastModeTransmission& interferer = fastModeTransmissions.at(transmission->getId());
+        if (interferer.carrierFrequency != entry.carrierFrequency || interferer.spreadingFactor != entry.spreadingFactor)
+            continue;
+        const IArrival *interferingArrival = getArrival(receiver, transmission);
+        if (interferingArrival == nullptr)
+            continue;
+        simtime_t m_y = (interferingArrival->getStartTime() + interferingArrival->getEndTime()) / 2;
+        simtime_t d_y = (interferingArrival->getEndTime() - interferingArrival->getStartTime()) / 2;
+        if (omnetpp::fabs(m_x - m_y) >= d_x + d_y)
+            continue;
+        if (loRaReceiver->isAlohaChannelModel())
+            return true;
+        double interferencePowerDbm = math::mW2dBm(mW(getFastModeReceptionPower(interferer, receiver)).get());
+        if (receptionPowerDbm - interferencePowerDbm < 6 && csBegin < interferingArrival->getEndTime())
+            return true;
+    }
+    return false;
+}
+double LoRaMedium::computeFastModeSNIR(const FastModeTransmission& entry, const IRadio *receiver, W receptionPower) const
+{
+    // Every overlapping signal on the channel is summed, so this is a lower bound of ScalarSNIR::getMin
+    const LoRaBandListening *listening = check_and_cast<const LoRaBandListening *>(getListening(receiver, entry.transmission));
+    const IArrival *arrival = getArrival(receiver, entry.transmission);
+    W noisePower = fastModeAnalogModel->getBackgroundNoisePower(listening);
+    for (const auto transmission : transmissions) {
+        if (transmission == entry.transmission || transmission->getTransmitter() == receiver)
+            continue;
+        const FastModeTransmission& interferer = fastModeTransmissions.at(transmission->getId());
+        if (interferer.carrierFrequency != entry.carrierFrequency || interferer.bandwidth != entry.bandwidth)
+            continue;
+        const IArrival *interferingArrival = getArrival(receiver, transmission);
+        if (interferingArrival != nullptr && interferingArrival->getStartTime() < arrival->getEndTime() && interferingArrival->getEndTime() > arrival->getStartTime())
+            noisePower += getFastModeReceptionPower(interferer, receiver);
+    }
+    return receptionPower.get() / noisePower.get();
+}
+const IListeningDecision *LoRaMedium::computeFastModeListeningDecision(const IRadio *radio, const IListening *listening) const
+{
+    listeningDecisionComputationCount++;
+    // Energy detection of LoRaReceiver::computeListeningDecision on the table powers
+    const LoRaBandListening *bandListening = check_and_cast<const LoRaBandListening *>(listening);
+    const LoRaReceiver *loRaReceiver = check_and_cast<const LoRaReceiver *>(radio->getReceiver());
+    W power = fastModeAnalogModel->getBackgroundNoisePower(bandListening);
+    for (const auto transmission : transmissions) {
+        const FastModeTransmission& entry = fastModeTransmissions.at(transmission->getId());
+        if (transmission->getTransmitter() == radio || entry.carrierFrequency != bandListening->getLoRaCF() || entry.bandwidth != bandListening->getLoRaBW())
+            continue;
+        const IArrival *arrival = getArrival(radio, transmission);
+        if (arrival != nullptr && arrival->getStartTime() < listening->getEndTime() && arrival->getEndTime() > listening->getStartTime())
+            power += getFastModeReceptionPower(entry, radio);
+    }
+    return new ListeningDecision(listening, power >= loRaReceiver->getEnergyDetection());
+}
 void LoRaMedium::sendToAllRadios(IRadio *transmitter, const IRadioFrame *frame)
 {
     for (const auto radio : radios)
@@ -631,7 +914,8 @@ void LoRaMedium::receiveSignal(cComponent *source, simsignal_t signal, long valu
                 delete communicationCache->getCachedListening(receiverRadio, transmission);
                 communicationCache->setCachedListening(receiverRadio, transmission, listening);
             }
-            if (communicationCache->getCachedFrame(receiverRadio, transmission) == nullptr &&
+            // Fast mode sends no radio frames, so there is nothing to pick up
+            if (!fastMode && communicationCache->getCachedFrame(receiverRadio, transmission) == nullptr &&
                 receiverRadio != transmitterRadio && isPotentialReceiver(receiverRadio, transmission))
             {
                 const IArrival *arrival = getArrival(receiverRadio, transmission);
@@ -657,5 +941,11 @@ void LoRaMedium::receiveSignal(cComponent *source, simsignal_t signal, long valu
     }
 }
 
+void LoRaMedium::receiveSignal(cComponent *source, simsignal_t signal, cObject *value, cObject *details)
+{
+    if (signal == NF_INTERFACE_CONFIG_CHANGED)
+        addressMapsValid = false;
+}
+
 }
 }
@@ -26,7 +26,10 @@
 #include "inet/physicallayer/contract/packetlevel/IMediumLimitCache.h"
 #include "inet/physicallayer/contract/packetlevel/INeighborCache.h"
 #include "inet/physicallayer/contract/packetlevel/IRadioMedium.h"
+#include "LoRaPhy/LoRaAnalogModel.h"
 #include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
 namespace inet {
 namespace physicallayer {
 class INET_API LoRaMedium : public cSimpleModule, public cListener, public IRadioMedium
@@ -98,6 +101,17 @@ class INET_API LoRaMedium : public cSimpleModule, public cListener, public IRadi
        * ${resultdir}/${configname}-${runnumber}.tlog
        */
       bool recordCommunicationLog;
+      /**
+       * Fast mode for parameter sweeps: no radio frames are sent. Each
+       * transmission gets an entry in the fast mode transmission table and is
+       * resolved when it ends; only the receivers that receive it successfully
+       * get its MAC frame, without any reception, interference or SNIR object.
+       */
+      bool fastMode = false;
+      /**
+       * The analog model as LoRaAnalogModel, set in fast mode only.
+       */
+      const LoRaAnalogModel *fastModeAnalogModel = nullptr;
       //@}
       /** @name Timer */
       //@{
@@ -121,6 +135,46 @@ class INET_API LoRaMedium : public cSimpleModule, public cListener, public IRadi
        * removed from the beginning. This list doesn't contain nullptr values.
        */
       std::vector<const ITransmission *> transmissions;
+      /**
+       * Radios of crashed or shut down nodes. They stay in the radios list, so
+       * the id-indexed caches keep their layout, but get no arrivals, no
+       * listenings and no radio frames until they are attached again.
+       */
+      std::unordered_set<const IRadio *> detachedRadios;
+      /**
+       * Entry of the fast mode transmission table: the LoRa parameters of a
+       * transmission, the radios that listened on its channel when it started
+       * and the reception powers computed so far, by radio id.
+       */
+      struct FastModeTransmission {
+          const ITransmission *transmission = nullptr;
+          Hz carrierFrequency = Hz(0);
+          Hz bandwidth = Hz(0);
+          int spreadingFactor = 0;
+          std::vector<const IRadio *> receivers;
+          mutable std::unordered_map<int, W> receptionPowers;
+          cMessage *endTimer = nullptr;
+      };
+      /**
+       * The fast mode transmission table, by transmission id. An entry lives as
+       * long as its transmission is in the transmissions list.
+       */
+      std::unordered_map<int, FastModeTransmission> fastModeTransmissions;
+      /**
+       * Maps LoRaMac DevAddr values to the radios of that MAC, used by the MAC
+       * address filter instead of searching every radio's interface table.
+       */
+      mutable std::unordered_map<uint64, std::vector<const IRadio *>> devAddrToRadios;
+      /**
+       * Maps interface MAC addresses to the radios of the owning node, used
+       * for MAC frames that are not LoRaMacFrames.
+       */
+      mutable std::unordered_map<uint64, std::vector<const IRadio *>> macAddressToRadios;
+      /**
+       * False after radios or interfaces changed; the address maps are then
+       * rebuilt on the next lookup.
+       */
+      mutable bool addressMapsValid = false;
       /**
        * TODO
        */
@@ -226,6 +280,30 @@ class INET_API LoRaMedium : public cSimpleModule, public cListener, public IRadi
        * Total number of reception result cache hits.
        */
       mutable long cacheResultHitCount;
+      /**
+       * Total number of frames not delivered in fast mode because the receiver
+       * was below sensitivity.
+       */
+      mutable long fastModeSkippedFrameCount = 0;
+      /**
+       * Total number of frames not delivered in fast mode because of a
+       * collision or because the receiver transmitted meanwhile.
+       */
+      mutable long fastModeCollidedFrameCount = 0;
+      /**
+       * Total number of frames delivered to MACs in fast mode.
+       */
+      mutable long fastModeDeliveredFrameCount = 0;
+      /**
+       * Total number of interfering transmissions whose reception was not
+       * computed because they are in a disjoint LoRa band.
+       */
+      mutable long otherBandReceptionSkipCount = 0;
+      /**
+       * Total number of frames that were not attempted without computing their
+       * reception because the receiver listens on another CF/BW/SF.
+       */
+      mutable long incompatibleReceptionSkipCount = 0;
       //@}
     protected:
       /** @name Module */
@@ -258,20 +336,63 @@ class INET_API LoRaMedium : public cSimpleModule, public cListener, public IRadi
        * Sends a copy of the provided radio frame to all receivers on the radio medium.
        */
       virtual void sendToAllRadios(IRadio *transmitter, const IRadioFrame *frame);
+      /**
+       * Adds the transmission to the fast mode transmission table and schedules
+       * its resolution at the end of its last arrival.
+       */
+      virtual void addFastModeTransmission(const IRadio *transmitter, const ITransmission *transmission);
+      /**
+       * Resolves an ended fast mode transmission and hands its MAC frame to
+       * the receivers that received it successfully.
+       */
+      virtual void endFastModeTransmission(cMessage *timer);
       //@}
       /** @name Reception */
       //@{
-      virtual bool isRadioMacAddress(const IRadio *radio, const MACAddress address) const;
+      /**
+       * Rebuilds the receiver address maps from the LoRaMacs and interface
+       * tables of the current radios.
+       */
+      virtual void updateAddressMaps() const;
+      /**
+       * Returns the radios addressed by the MAC frame of the transmission, or
+       * nullptr if the frame is broadcast or multicast.
+       */
+      virtual const std::vector<const IRadio *> *getAddressedRadios(const ITransmission *transmission) const;
+      virtual bool isAddressedRadio(const IRadio *radio, const ITransmission *transmission) const;
       /**
        * Returns true if the radio can potentially receive the transmission
        * successfully. If this function returns false then the radio medium
        * doesn't send a radio frame to this receiver.
        */
       virtual bool isPotentialReceiver(const IRadio *receiver, const ITransmission *transmission) const;
+      /**
+       * Returns the reception power of the fast mode transmission at the
+       * receiver; computed once and kept in the table entry.
+       */
+      virtual W getFastModeReceptionPower(const FastModeTransmission& entry, const IRadio *receiver) const;
+      /**
+       * Returns true if the fast mode transmission is lost at the receiver:
+       * LoRaReceiver::isPacketCollided on the table, plus half duplex.
+       */
+      virtual bool isFastModeReceptionCollided(const FastModeTransmission& entry, const IRadio *receiver, W receptionPower) const;
+      virtual double computeFastModeSNIR(const FastModeTransmission& entry, const IRadio *receiver, W receptionPower) const;
+      virtual const IListeningDecision *computeFastModeListeningDecision(const IRadio *receiver, const IListening *listening) const;
       virtual bool isInCommunicationRange(const ITransmission *transmission, const Coord startPosition, const Coord endPosition) const;
       virtual bool isInInterferenceRange(const ITransmission *transmission, const Coord startPosition, const Coord endPosition) const;
       virtual bool isInterferingTransmission(const ITransmission *transmission, const IListening *listening) const;
       virtual bool isInterferingTransmission(const ITransmission *transmission, const IReception *reception) const;
+      /**
+       * Returns false if the transmission is in a LoRa band disjoint from the
+       * given one. Such signals neither add noise (LoRaAnalogModel) nor collide
+       * (LoRaReceiver), so their reception does not need to be computed.
+       */
+      virtual bool isInLoRaBand(const ITransmission *transmission, Hz carrierFrequency, Hz bandwidth) const;
+      /**
+       * Returns false if the receiver cannot demodulate the transmission with
+       * its listening parameters; checked before the reception is computed.
+       */
+      virtual bool isCompatibleTransmission(const IRadio *receiver, const IListening *listening, const ITransmission *transmission) const;
       /**
        * Removes all cached data related to past transmissions that don't have
        * any effect on any ongoing transmission. Note that it's possible that a
@@ -317,6 +438,17 @@ class INET_API LoRaMedium : public cSimpleModule, public cListener, public IRadi
       virtual const ICommunicationCache *getCommunicationCache() const override { return communicationCache; }
       virtual void addRadio(const IRadio *radio) override;
       virtual void removeRadio(const IRadio *radio) override;
+      /**
+       * Takes the radio of a failed node off the medium: no PHY work is done
+       * for it and it is dropped from the neighbor cache until attachRadio().
+       */
+      virtual void detachRadio(const IRadio *radio);
+      /**
+       * Puts a detached radio back on the medium, including the arrivals of
+       * the transmissions that are still ongoing.
+       */
+      virtual void attachRadio(const IRadio *radio);
+      virtual bool isRadioDetached(const IRadio *radio) const { return !detachedRadios.empty() && detachedRadios.count(radio) != 0; }
       virtual void sendToRadio(IRadio *trasmitter, const IRadio *receiver, const IRadioFrame *frame);
       virtual IRadioFrame *transmitPacket(const IRadio *transmitter, cPacket *macFrame) override;
       virtual cPacket *receivePacket(const IRadio *receiver, IRadioFrame *radioFrame) override;
@@ -334,6 +466,7 @@ class INET_API LoRaMedium : public cSimpleModule, public cListener, public IRadi
       virtual const IReceptionDecision *getReceptionDecision(const IRadio *receiver, const IListening *listening, const ITransmission *transmission, IRadioSignal::SignalPart part) const override;
       virtual const IReceptionResult *getReceptionResult(const IRadio *receiver, const IListening *listening, const ITransmission *transmission) const override;
       virtual void receiveSignal(cComponent *source, simsignal_t signal, long value);
+      virtual void receiveSignal(cComponent *source, simsignal_t signal, cObject *value, cObject *details) override;
 };
 }
 }
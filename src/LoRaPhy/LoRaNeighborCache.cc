@@ -109,7 +109,15 @@ void LoRaNeighborCache::addRadio(const IRadio *radio)
     RadioEntry *newEntry = new RadioEntry(radio);
     radios.push_back(newEntry);
     radioToEntry[radio] = newEntry;
-    updateNeighborLists();
+    if (initialized()) {
+        // A radio joining later (e.g. a recovered node) only changes its own
+        // list and the lists of the radios within the cache radius
+        updateNeighborList(newEntry);
+        for (const auto neighbor : newEntry->neighborVector)
+            radioToEntry[neighbor]->neighborVector.push_back(radio);
+    }
+    else
+        updateNeighborLists();
     maxSpeed = radioMedium->getMediumLimitCache()->getMaxSpeed().get();
     if (maxSpeed != 0 && !updateNeighborListsTimer->isScheduled() && initialized())
         scheduleAt(simTime() + refillPeriod, updateNeighborListsTimer);
@@ -117,10 +125,13 @@ void LoRaNeighborCache::addRadio(const IRadio *radio)
 
 void LoRaNeighborCache::removeRadio(const IRadio *radio)
 {
-    auto it = find(radios.begin(), radios.end(), radioToEntry[radio]);
+    auto entryIt = radioToEntry.find(radio);
+    auto it = entryIt != radioToEntry.end() ? find(radios.begin(), radios.end(), entryIt->second) : radios.end();
     if (it != radios.end()) {
-        removeRadioFromNeighborLists(radio);
         radios.erase(it);
+        delete entryIt->second;
+        radioToEntry.erase(entryIt);
+        removeRadioFromNeighborLists(radio);
         maxSpeed = radioMedium->getMediumLimitCache()->getMaxSpeed().get();
         if (maxSpeed == 0 && initialized())
             cancelEvent(updateNeighborListsTimer);
@@ -140,7 +151,7 @@ void LoRaNeighborCache::updateNeighborLists()
 void LoRaNeighborCache::removeRadioFromNeighborLists(const IRadio *radio)
 {
     for (auto & elem : radios) {
-        Radios neighborVector = elem->neighborVector;
+        Radios& neighborVector = elem->neighborVector;
         auto it = find(neighborVector.begin(), neighborVector.end(), radio);
         if (it != neighborVector.end())
             neighborVector.erase(it);
@@ -14,6 +14,7 @@
 // 
 
 #include "LoRaPathLossOulu.h"
+#include "LoRaLinkBudget.h"
 
 namespace inet {
 
@@ -42,7 +43,7 @@ double LoRaPathLossOulu::computePathLoss(mps propagationSpeed, Hz frequency, m d
     //EPL = B + 10nlog10( d / d0 )
     //double PL_d0_db = 127.41;
     //double PL_db = PL_d0_db + 10 * gamma * log10(unit(distance / d0).get()) + normal(0.0, sigma);
-    double PL_db = B + 10 * n * log10(unit(distance/d0).get()) - antennaGain + normal(0.0, sigma);
+    double PL_db = linkbudget::ouluPathLossDb(distance.get(), d0.get(), n, B, antennaGain) + normal(0.0, sigma);
     return math::dB2fraction(-PL_db);
 }
 
@@ -14,7 +14,10 @@
 // 
 
 #include "LoRaReceiver.h"
+#include "LoRaLinkBudget.h"
+#include "misc/LoRaScalarCollector.h"
 #include "inet/physicallayer/analogmodel/packetlevel/ScalarNoise.h"
+#include "inet/common/ModuleAccess.h"
 #include "LoRaApp/LoRaEndNodeApp.h"
 
 namespace inet {
@@ -32,8 +35,15 @@ void LoRaReceiver::initialize(int stage)
 {
     if (stage == INITSTAGE_LOCAL)
     {
-        myRssi.setName("RSSI Vector");
-        mySnr.setName("SNR Vector");
+        int decimation = par("statisticDecimation");
+        myRssi.setMode(LoRaStreamingStatistic::parseMode(par("rssiStatistic").stdstringValue()), "RSSI dBm Vector", "dBm");
+        myRssi.setResolution(0.1);
+        myRssi.setDecimation(decimation);
+        mySnr.setMode(LoRaStreamingStatistic::parseMode(par("snirStatistic").stdstringValue()), "SNIR dB Vector", "dB");
+        mySnr.setResolution(0.1);
+        mySnr.setDecimation(decimation);
+        perSFStatistics = par("perSFStatistics");
+        perLinkStatistics = par("perLinkStatistics");
 
         myTimeOnAir.setName("Time One Air");
 
@@ -54,9 +64,21 @@ void LoRaReceiver::initialize(int stage)
 
 void LoRaReceiver::finish()
 {
-        recordScalar("numCollisions", numCollisions);
+        LoRaScalarCollector::record(this, "numCollisions", numCollisions);
         std::cout<<"number of collisions "<< numCollisions<<std::endl;
-        recordScalar("rcvBelowSensitivity", rcvBelowSensitivity);
+        LoRaScalarCollector::record(this, "rcvBelowSensitivity", rcvBelowSensitivity);
+
+        myRssi.recordScalars(this, "rssi", "dBm");
+        mySnr.recordScalars(this, "snir", "dB");
+        for (const auto& sf : rssiPerSF)
+            sf.second.recordScalars(this, ("rssi-SF" + std::to_string(sf.first)).c_str(), "dBm");
+        for (const auto& link : rssiPerLink) {
+            // Named after the transmitting node, e.g. rssiFrom-loRaNodes[3]
+            cModule *radio = getSimulation()->getModule(link.first);
+            cModule *host = radio != nullptr ? findContainingNode(radio) : nullptr;
+            std::string from = host != nullptr ? host->getFullName() : std::to_string(link.first);
+            link.second.recordScalars(this, ("rssiFrom-" + from).c_str(), "dBm");
+        }
 
 }
 
@@ -90,22 +112,36 @@ bool LoRaReceiver::computeIsReceptionPossible(const IListening *listening, const
     }
 }
 
-bool LoRaReceiver::computeIsReceptionPossible(const IListening *listening, const IReception *reception, IRadioSignal::SignalPart part) const
+bool LoRaReceiver::isCadEnabled() const
 {
     cModule *appModule = getParentModule()->getParentModule()->getParentModule()->getSubmodule("LoRaNodeApp");
     LoRaNodeApp *loRaApp = dynamic_cast<LoRaNodeApp *>(appModule);
-    LoRaEndNodeApp *endApp = nullptr;
-    if (!loRaApp) {
-        endApp = dynamic_cast<LoRaEndNodeApp *>(appModule);
-    }
+    if (loRaApp)
+        return loRaApp->loRaCAD;
+    LoRaEndNodeApp *endApp = dynamic_cast<LoRaEndNodeApp *>(appModule);
+    return endApp && endApp->loRaCAD;
+}
+
+bool LoRaReceiver::isTransmissionCompatible(const IListening *listening, const ITransmission *transmission) const
+{
+    if (iAmGateway)
+        return true;
+    const LoRaBandListening *loRaListening = check_and_cast<const LoRaBandListening *>(listening);
+    const LoRaTransmission *loRaTransmission = check_and_cast<const LoRaTransmission *>(transmission);
+    if (loRaListening->getLoRaCF() != loRaTransmission->getLoRaCF() || loRaListening->getLoRaBW() != loRaTransmission->getLoRaBW())
+        return false;
+    // If CAD is enabled on the node, the node should be able to receive a packet regardless of the SF being used (sensitivity may be affected, though).
+    return loRaListening->getLoRaSF() == loRaTransmission->getLoRaSF() || isCadEnabled();
+}
+
+bool LoRaReceiver::computeIsReceptionPossible(const IListening *listening, const IReception *reception, IRadioSignal::SignalPart part) const
+{
     //here we can check compatibility of LoRaTx parameters (or beeing a gateway) and reception above sensitivity level
     const LoRaBandListening *loRaListening = check_and_cast<const LoRaBandListening *>(listening);
     const LoRaReception *loRaReception = check_and_cast<const LoRaReception *>(reception);
 
     // If CAD is enabled on the node, the node should be able to receive a packet regardless of the SF being used (sensitivity may be affected, though).
-    bool cadEnabled = false;
-    if (loRaApp) cadEnabled = loRaApp->loRaCAD; else if (endApp) cadEnabled = endApp->loRaCAD;
-    if (iAmGateway == false && (loRaListening->getLoRaCF() != loRaReception->getLoRaCF() || loRaListening->getLoRaBW() != loRaReception->getLoRaBW() || (cadEnabled == false && loRaListening->getLoRaSF() != loRaReception->getLoRaSF()))) {
+    if (iAmGateway == false && (loRaListening->getLoRaCF() != loRaReception->getLoRaCF() || loRaListening->getLoRaBW() != loRaReception->getLoRaBW() || (loRaListening->getLoRaSF() != loRaReception->getLoRaSF() && isCadEnabled() == false))) {
         std::cout<<"checking false"<<std::endl;
         return false;
     } else {
@@ -261,19 +297,22 @@ const IReceptionDecision *LoRaReceiver::computeReceptionDecision(const IListenin
     auto isReceptionAttempted = isReceptionPossible && computeIsReceptionAttempted(listening, reception, part, interference);
     auto isReceptionSuccessful = isReceptionAttempted && computeIsReceptionSuccessful(listening, reception, part, interference, snir);
     const LoRaReception *loRaReception = check_and_cast<const LoRaReception *>(reception);
-    W RSSI = loRaReception->computeMinPower(reception->getStartTime(part), reception->getEndTime(part));
-    EV_INFO << "RSSI for this is me = " << RSSI << endl;
-//    myRssi.record(RSSI);
-    double RSSII = RSSI.get();
-    EV_INFO << "RSSSI for me= "<< RSSII<<endl;
-    myRssi.record(RSSII);
-
+    if (myRssi.isEnabled() || perSFStatistics || perLinkStatistics) {
+        W RSSI = loRaReception->computeMinPower(reception->getStartTime(part), reception->getEndTime(part));
+        EV_INFO << "RSSI for this is me = " << RSSI << endl;
+        double rssiDbm = math::mW2dBm(mW(RSSI).get());
+        myRssi.collect(rssiDbm);
+        if (perSFStatistics)
+            rssiPerSF[loRaReception->getLoRaSF()].collect(rssiDbm);
+        if (perLinkStatistics)
+            if (auto transmitter = dynamic_cast<const cModule *>(reception->getTransmission()->getTransmitter()))
+                rssiPerLink[transmitter->getId()].collect(rssiDbm);
+    }
 
     if (snir) {
-            // Adjust the method names based on your ISNIR class
-            double snr = snir->getMin();
-            mySnr.record(snr);
-            std::cout << "SNR for this is me = " << snr << std::endl;
+            double snr = math::fraction2dB(snir->getMin());
+            mySnr.collect(snr);
+            EV_INFO << "SNR for this is me = " << snr << endl;
         } else {
             EV_INFO << "SNR information not available" << endl;
         }
@@ -347,6 +386,11 @@ const IListeningDecision *LoRaReceiver::computeListeningDecision(const IListenin
 }
 
 W LoRaReceiver::getSensitivity(const LoRaReception *reception) const
+{
+    return getSensitivity(reception->getLoRaSF(), reception->getLoRaBW());
+}
+
+W LoRaReceiver::getSensitivity(int loRaSF, Hz loRaBW) const
 {
     //function returns sensitivity -- according to LoRa documentation, it changes with LoRa parameters
     //Sensitivity values from Semtech SX1272/73 datasheet, table 10, Rev 3.1, March 2017
@@ -371,48 +415,9 @@ W LoRaReceiver::getSensitivity(const LoRaReception *reception) const
     else if (endApp2) { cad = endApp2->loRaCAD; cadAtt = endApp2->loRaCADatt; }
     if (cad) loRaCADatt = cadAtt;
 
-    if(reception->getLoRaSF() == 6)
-    {
-        if(reception->getLoRaBW() == Hz(125000)) sensitivity = W(math::dBm2mW(-121 + loRaCADatt) / 1000);
-        else if(reception->getLoRaBW() == Hz(250000)) sensitivity = W(math::dBm2mW(-118 + loRaCADatt) / 1000);
-        else if(reception->getLoRaBW() == Hz(500000)) sensitivity = W(math::dBm2mW(-111 + loRaCADatt) / 1000);
-    }
-    else if (reception->getLoRaSF() == 7)
-    {
-        if(reception->getLoRaBW() == Hz(125000)) sensitivity = W(math::dBm2mW(-124 + loRaCADatt) / 1000);
-        else if(reception->getLoRaBW() == Hz(250000)) sensitivity = W(math::dBm2mW(-122 + loRaCADatt) / 1000);
-        else if(reception->getLoRaBW() == Hz(500000)) sensitivity = W(math::dBm2mW(-116 + loRaCADatt) / 1000);
-    }
-    else if(reception->getLoRaSF() == 8)
-    {
-        if(reception->getLoRaBW() == Hz(125000)) sensitivity = W(math::dBm2mW(-127 + loRaCADatt) / 1000);
-        else if(reception->getLoRaBW() == Hz(250000)) sensitivity = W(math::dBm2mW(-125 + loRaCADatt) / 1000);
-        else if(reception->getLoRaBW() == Hz(500000)) sensitivity = W(math::dBm2mW(-119 + loRaCADatt) / 1000);
-    }
-    else if(reception->getLoRaSF() == 9)
-    {
-        if(reception->getLoRaBW() == Hz(125000)) sensitivity = W(math::dBm2mW(-130 + loRaCADatt) / 1000);
-        else if(reception->getLoRaBW() == Hz(250000)) sensitivity = W(math::dBm2mW(-128 + loRaCADatt) / 1000);
-        else if(reception->getLoRaBW() == Hz(500000)) sensitivity = W(math::dBm2mW(-122 + loRaCADatt) / 1000);
-    }
-    else if(reception->getLoRaSF() == 10)
-    {
-        if(reception->getLoRaBW() == Hz(125000)) sensitivity = W(math::dBm2mW(-133 + loRaCADatt) / 1000);
-        else if(reception->getLoRaBW() == Hz(250000)) sensitivity = W(math::dBm2mW(-130 + loRaCADatt) / 1000);
-        else if(reception->getLoRaBW() == Hz(500000)) sensitivity = W(math::dBm2mW(-125 + loRaCADatt) / 1000);
-    }
-    else if(reception->getLoRaSF() == 11)
-    {
-        if(reception->getLoRaBW() == Hz(125000)) sensitivity = W(math::dBm2mW(-135 + loRaCADatt) / 1000);
-        else if(reception->getLoRaBW() == Hz(250000)) sensitivity = W(math::dBm2mW(-132 + loRaCADatt) / 1000);
-        else if(reception->getLoRaBW() == Hz(500000)) sensitivity = W(math::dBm2mW(-128 + loRaCADatt) / 1000);
-    }
-    else if(reception->getLoRaSF() == 12)
-    {
-        if(reception->getLoRaBW() == Hz(125000)) sensitivity = W(math::dBm2mW(-137 + loRaCADatt) / 1000);
-        else if(reception->getLoRaBW() == Hz(250000)) sensitivity = W(math::dBm2mW(-135 + loRaCADatt) / 1000);
-        else if(reception->getLoRaBW() == Hz(500000)) sensitivity = W(math::dBm2mW(-129 + loRaCADatt) / 1000);
-    }
+    double sensitivityDbm = linkbudget::loRaSensitivityDbm(loRaSF, loRaBW.get());
+    if (!std::isnan(sensitivityDbm))
+        sensitivity = W(math::dBm2mW(sensitivityDbm + loRaCADatt) / 1000);
 
     return sensitivity;
 }
@@ -28,6 +28,7 @@
 #include "LoRaReception.h"
 #include "LoRaBandListening.h"
 #include "LoRa/LoRaRadio.h"
+#include "misc/LoRaStreamingStatistic.h"
 #include "LoRaApp/LoRaNodeApp.h"
 #include "LoRa/LoRaMac.h"
 #include "LoRa/LoRaGWMac.h"
@@ -52,9 +53,14 @@ private:
     Hz LoRaBW;
     double LoRaCR;
 
-//    cOutVector myRssi;
-    mutable cOutVector myRssi;
-    mutable cOutVector mySnr;
+    // RSSI (dBm) and SNIR (dB) of every reception decision, summarized per rssiStatistic/snirStatistic;
+    // optionally the RSSI per SF and per transmitting radio (module id) as well
+    mutable LoRaStreamingStatistic myRssi;
+    mutable LoRaStreamingStatistic mySnr;
+    mutable std::map<int, LoRaStreamingStatistic> rssiPerSF;
+    mutable std::map<int, LoRaStreamingStatistic> rssiPerLink;
+    bool perSFStatistics;
+    bool perLinkStatistics;
 
     mutable  cOutVector myTimeOnAir;
 
@@ -100,9 +106,16 @@ public:
   virtual const IListeningDecision *computeListeningDecision(const IListening *listening, const IInterference *interference) const override;
 
   W getSensitivity(const LoRaReception *loRaReception) const;
+  W getSensitivity(int loRaSF, Hz loRaBW) const;
+  W getEnergyDetection() const { return energyDetection; }
+  bool isAlohaChannelModel() const { return alohaChannelModel; }
 
   bool isPacketCollided(const IReception *reception, IRadioSignal::SignalPart part, const IInterference *interference) const;
 
+  // CF/BW/SF check of computeIsReceptionPossible on the transmission, so no reception has to be computed
+  bool isTransmissionCompatible(const IListening *listening, const ITransmission *transmission) const;
+  bool isCadEnabled() const;
+
   virtual void setLoRaTP(W newTP) { LoRaTP = newTP; };
   virtual void setLoRaCF(Hz newCF) { LoRaCF = newCF; };
   virtual void setLoRaSF(int newSF) { LoRaSF = newSF; };
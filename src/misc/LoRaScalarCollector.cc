@@ -0,0 +1,232 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include "LoRaScalarCollector.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+namespace inet {
+
+Define_Module(LoRaScalarCollector);
+
+LoRaScalarCollector *LoRaScalarCollector::instance = nullptr;
+
+namespace {
+
+// Shortest text that reads back as the same double; NaN and infinities are left empty
+std::string formatValue(double value)
+{
+    if (!std::isfinite(value))
+        return "";
+    char text[32];
+    snprintf(text, sizeof(text), "%.17g", value);
+    for (int precision = 6; precision < 17; precision++) {
+        char shorter[32];
+        snprintf(shorter, sizeof(shorter), "%.*g", precision, value);
+        if (strtod(shorter, nullptr) == value)
+            return shorter;
+    }
+    return text;
+}
+
+std::string quoteJson(const std::string& text)
+{
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\')
+            quoted += '\\';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+std::string quoteCsv(const std::string& text)
+{
+    if (text.find_first_of(",\"") == std::string::npos)
+        return text;
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"')
+            quoted += '"';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+}
+
+LoRaScalarCollector::~LoRaScalarCollector()
+{
+    if (instance == this)
+        instance = nullptr;
+}
+
+void LoRaScalarCollector::initialize()
+{
+    std::string format = par("format").stdstringValue();
+    if (format != "csv" && format != "json")
+        throw cRuntimeError("Unknown format '%s' (csv or json)", format.c_str());
+    if (instance != nullptr && instance != this)
+        throw cRuntimeError("Only one LoRaScalarCollector per network");
+    instance = this;
+}
+
+void LoRaScalarCollector::handleMessage(cMessage *msg)
+{
+    throw cRuntimeError("LoRaScalarCollector does not process messages");
+}
+
+void LoRaScalarCollector::record(cComponent *component, const char *name, double value, const char *unit)
+{
+    component->recordScalar(name, value, unit);
+    if (instance != nullptr)
+        instance->collect(component, name, value);
+}
+
+void LoRaScalarCollector::record(cComponent *component, const char *name, cStatistic& statistic, const char *unit)
+{
+    statistic.recordAs(name, unit);
+    if (instance != nullptr) {
+        std::string prefix = name;
+        instance->collect(component, prefix + ":count", statistic.getCount());
+        if (statistic.getCount() > 0) {
+            instance->collect(component, prefix + ":mean", statistic.getMean());
+            instance->collect(component, prefix + ":stddev", statistic.getStddev());
+            instance->collect(component, prefix + ":min", statistic.getMin());
+            instance->collect(component, prefix + ":max", statistic.getMax());
+        }
+    }
+}
+
+void LoRaScalarCollector::collect(cComponent *component, const std::string& name, double value)
+{
+    if (written) {
+        EV_WARN << "Scalar " << name << " of " << component->getFullPath() << " recorded after the summary was written" << endl;
+        return;
+    }
+    // The row is the top-level module holding the component (the node), the
+    // column the rest of the component's path plus the scalar name
+    cModule *system = getSimulation()->getSystemModule();
+    cModule *node = component->isModule() ? static_cast<cModule *>(component) : component->getParentModule();
+    while (node != nullptr && node->getParentModule() != system && node != system)
+        node = node->getParentModule();
+    std::string nodeName = node != nullptr && node != system ? node->getFullName() : "network";
+    std::string path = component->getFullPath();
+    std::string prefix = node != nullptr && node != system ? node->getFullPath() : system->getFullPath();
+    std::string metric = path.size() > prefix.size() ? path.substr(prefix.size() + 1) + "." + name : name;
+
+    int column = getColumn(metric);
+    int row = getRow(nodeName);
+    values[column][row] = value;
+}
+
+int LoRaScalarCollector::getColumn(const std::string& metric)
+{
+    auto found = metricIndex.find(metric);
+    if (found != metricIndex.end())
+        return found->second;
+    metricIndex.emplace(metric, metrics.size());
+    metrics.push_back(metric);
+    values.emplace_back(nodes.size(), NAN);
+    return metrics.size() - 1;
+}
+
+int LoRaScalarCollector::getRow(const std::string& node)
+{
+    auto found = nodeIndex.find(node);
+    if (found != nodeIndex.end())
+        return found->second;
+    nodeIndex.emplace(node, nodes.size());
+    nodes.push_back(node);
+    for (auto& column : values)
+        column.push_back(NAN);
+    return nodes.size() - 1;
+}
+
+void LoRaScalarCollector::finish()
+{
+    std::string path = getFilePath();
+    size_t slash = path.find_last_of("/\\");
+    if (slash != std::string::npos) {
+#ifdef _WIN32
+        _mkdir(path.substr(0, slash).c_str());
+#else
+        mkdir(path.substr(0, slash).c_str(), 0775);
+#endif
+    }
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    if (!out.is_open())
+        throw cRuntimeError("Cannot write %s", path.c_str());
+    if (par("format").stdstringValue() == "json")
+        writeJson(out);
+    else
+        writeCsv(out);
+    written = true;
+    recordScalar("summaryNodes", nodes.size());
+    recordScalar("summaryMetrics", metrics.size());
+}
+
+std::string LoRaScalarCollector::getFilePath() const
+{
+    cConfigurationEx *config = getEnvir()->getConfigEx();
+    std::stringstream path;
+    path << par("fileName").stdstringValue() << '-' << config->getActiveConfigName() << '-' << config->getActiveRunNumber()
+         << '.' << par("format").stdstringValue();
+    return path.str();
+}
+
+void LoRaScalarCollector::writeCsv(std::ostream& out) const
+{
+    out << "node";
+    for (const auto& metric : metrics)
+        out << ',' << quoteCsv(metric);
+    out << '\n';
+    for (size_t row = 0; row < nodes.size(); row++) {
+        out << quoteCsv(nodes[row]);
+        for (const auto& column : values)
+            out << ',' << formatValue(column[row]);
+        out << '\n';
+    }
+}
+
+void LoRaScalarCollector::writeJson(std::ostream& out) const
+{
+    // Columnar: the node names once, then one array per metric in the same order
+    out << "{\n  \"nodes\": [";
+    for (size_t row = 0; row < nodes.size(); row++)
+        out << (row ? ", " : "") << quoteJson(nodes[row]);
+    out << "],\n  \"metrics\": {";
+    for (size_t column = 0; column < metrics.size(); column++) {
+        out << (column ? ",\n    " : "\n    ") << quoteJson(metrics[column]) << ": [";
+        for (size_t row = 0; row < nodes.size(); row++) {
+            std::string value = formatValue(values[column][row]);
+            out << (row ? ", " : "") << (value.empty() ? "null" : value);
+        }
+        out << ']';
+    }
+    out << "\n  }\n}\n";
+}
+
+}
@@ -0,0 +1,73 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#ifndef __LORA_OMNET_LORASCALARCOLLECTOR_H_
+#define __LORA_OMNET_LORASCALARCOLLECTOR_H_
+
+#include <omnetpp.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace omnetpp;
+
+namespace inet {
+
+/**
+ * Simulation-wide sink for the end-of-run scalars of the nodes. Modules
+ * record through the static record() helpers, which write the scalar as
+ * usual (subject to scalar-recording) and, when a collector exists, also
+ * store it in a node x metric matrix. Rows are the top-level modules that
+ * contain the recording component, columns the component's path inside
+ * that module plus the scalar name; both keep their order of appearance.
+ */
+class INET_API LoRaScalarCollector : public cSimpleModule
+{
+    protected:
+        static LoRaScalarCollector *instance;
+
+        std::vector<std::string> nodes;
+        std::unordered_map<std::string, int> nodeIndex;
+        std::vector<std::string> metrics;
+        std::unordered_map<std::string, int> metricIndex;
+        std::vector<std::vector<double>> values;  // [metric][node], NaN where not recorded
+        bool written = false;
+
+    protected:
+        virtual void initialize() override;
+        virtual void handleMessage(cMessage *msg) override;
+        virtual void finish() override;
+
+        void collect(cComponent *component, const std::string& name, double value);
+        int getColumn(const std::string& metric);
+        int getRow(const std::string& node);
+        std::string getFilePath() const;
+        void writeCsv(std::ostream& out) const;
+        void writeJson(std::ostream& out) const;
+
+    public:
+        virtual ~LoRaScalarCollector();
+
+        /** recordScalar() on the component, mirrored into the collector if there is one. */
+        static void record(cComponent *component, const char *name, double value, const char *unit = nullptr);
+        static void record(cComponent *component, const std::string& name, double value, const char *unit = nullptr) { record(component, name.c_str(), value, unit); }
+        static void record(cComponent *component, const char *name, SimTime value, const char *unit = nullptr) { record(component, name, value.dbl(), unit); }
+        /** recordAs() on the statistic; the collector gets its count, mean, stddev, min and max. */
+        static void record(cComponent *component, const char *name, cStatistic& statistic, const char *unit = nullptr);
+};
+
+}
+
+#endif
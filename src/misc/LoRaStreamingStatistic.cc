@@ -0,0 +1,140 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <cmath>
+
+#include "LoRaStreamingStatistic.h"
+#include "LoRaScalarCollector.h"
+
+namespace inet {
+
+LoRaStreamingStatistic::Mode LoRaStreamingStatistic::parseMode(const std::string& mode)
+{
+    if (mode == "none")
+        return MODE_NONE;
+    if (mode == "summary")
+        return MODE_SUMMARY;
+    if (mode == "decimated")
+        return MODE_DECIMATED;
+    if (mode == "vector")
+        return MODE_VECTOR;
+    throw cRuntimeError("Unknown statistic mode '%s' (none, summary, decimated or vector)", mode.c_str());
+}
+
+void LoRaStreamingStatistic::setMode(Mode mode, const char *vectorName, const char *unit)
+{
+    this->mode = mode;
+    if (mode == MODE_DECIMATED || mode == MODE_VECTOR) {
+        vector.reset(new cOutVector(vectorName));
+        if (unit != nullptr)
+            vector->setUnit(unit);
+    }
+    else
+        vector.reset();
+}
+
+void LoRaStreamingStatistic::setResolution(double resolution)
+{
+    if (resolution <= 0)
+        throw cRuntimeError("Statistic resolution must be positive");
+    if (count > 0)
+        throw cRuntimeError("Cannot change the resolution of a statistic with samples");
+    this->resolution = resolution;
+}
+
+void LoRaStreamingStatistic::setDecimation(int samples)
+{
+    if (samples < 1)
+        throw cRuntimeError("Statistic decimation must be at least 1");
+    decimation = samples;
+}
+
+void LoRaStreamingStatistic::collect(double value)
+{
+    if (mode == MODE_NONE || std::isnan(value))
+        return;
+    if (count == 0)
+        min = max = value;
+    else if (value < min)
+        min = value;
+    else if (value > max)
+        max = value;
+    count++;
+    sum += value;
+    sumSquares += value * value;
+    buckets[(long)std::floor(value / resolution)]++;
+
+    if (mode == MODE_VECTOR)
+        vector->record(value);
+    else if (mode == MODE_DECIMATED) {
+        windowSum += value;
+        if (++windowCount == decimation) {
+            vector->record(windowSum / windowCount);
+            windowSum = 0;
+            windowCount = 0;
+        }
+    }
+}
+
+double LoRaStreamingStatistic::getMean() const
+{
+    return count == 0 ? NAN : sum / count;
+}
+
+double LoRaStreamingStatistic::getStddev() const
+{
+    if (count < 2)
+        return NAN;
+    double variance = (sumSquares - sum * sum / count) / (count - 1);
+    return variance <= 0 ? 0 : std::sqrt(variance);
+}
+
+double LoRaStreamingStatistic::getQuantile(double q) const
+{
+    if (count == 0)
+        return NAN;
+    // Midpoint of the bucket holding the sample of rank q * (count - 1), rounded to the nearest
+    // sample and kept within [min, max]
+    double rank = floor(q * (count - 1) + 0.5);
+    long seen = 0;
+    for (const auto& bucket : buckets) {
+        seen += bucket.second;
+        if (seen > rank) {
+            double value = (bucket.first + 0.5) * resolution;
+            return value < min ? min : value > max ? max : value;
+        }
+    }
+    return max;
+}
+
+void LoRaStreamingStatistic::recordScalars(cComponent *component, const char *name, const char *unit) const
+{
+    if (mode == MODE_NONE)
+        return;
+    std::string prefix = name;
+    LoRaScalarCollector::record(component, (prefix + ":count").c_str(), count);
+    if (count == 0)
+        return;
+    LoRaScalarCollector::record(component, (prefix + ":mean").c_str(), getMean(), unit);
+    if (count > 1)
+        LoRaScalarCollector::record(component, (prefix + ":stddev").c_str(), getStddev(), unit);
+    LoRaScalarCollector::record(component, (prefix + ":min").c_str(), min, unit);
+    LoRaScalarCollector::record(component, (prefix + ":max").c_str(), max, unit);
+    LoRaScalarCollector::record(component, (prefix + ":p50").c_str(), getQuantile(0.5), unit);
+    LoRaScalarCollector::record(component, (prefix + ":p95").c_str(), getQuantile(0.95), unit);
+    LoRaScalarCollector::record(component, (prefix + ":p99").c_str(), getQuantile(0.99), unit);
+}
+
+}
@@ -0,0 +1,79 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#ifndef __LORA_OMNET_LORASTREAMINGSTATISTIC_H_
+#define __LORA_OMNET_LORASTREAMINGSTATISTIC_H_
+
+#include <omnetpp.h>
+#include <map>
+#include <memory>
+#include <string>
+
+using namespace omnetpp;
+
+namespace inet {
+
+/**
+ * A statistic summarized while the simulation runs instead of written to a
+ * vector file sample by sample. Every mode but "none" keeps count, mean,
+ * standard deviation, min, max and quantiles; the quantiles come from a
+ * sparse histogram with fixed-width buckets (`resolution`), so their error
+ * is bounded by the resolution and the memory by the range of values seen.
+ * On top of that, "decimated" writes the mean of every `decimation` samples
+ * to a vector and "vector" writes every sample, like a plain cOutVector.
+ */
+class LoRaStreamingStatistic
+{
+    public:
+        enum Mode { MODE_NONE, MODE_SUMMARY, MODE_DECIMATED, MODE_VECTOR };
+
+    protected:
+        Mode mode = MODE_SUMMARY;
+        double resolution = 1;
+        int decimation = 100;
+        long count = 0;
+        double sum = 0;
+        double sumSquares = 0;
+        double min = 0;
+        double max = 0;
+        std::map<long, long> buckets;  // floor(value / resolution) -> samples
+        double windowSum = 0;
+        int windowCount = 0;
+        std::unique_ptr<cOutVector> vector;
+
+    public:
+        /** "none", "summary", "decimated" or "vector"; throws on anything else. */
+        static Mode parseMode(const std::string& mode);
+
+        /** vectorName and unit are only used by the decimated and vector modes. */
+        void setMode(Mode mode, const char *vectorName = nullptr, const char *unit = nullptr);
+        void setResolution(double resolution);
+        void setDecimation(int samples);
+        bool isEnabled() const { return mode != MODE_NONE; }
+
+        void collect(double value);
+
+        long getCount() const { return count; }
+        double getMean() const;
+        double getStddev() const;
+        double getQuantile(double q) const;
+
+        /** Records name:count, and with samples :mean, :stddev, :min, :max, :p50, :p95 and :p99. */
+        void recordScalars(cComponent *component, const char *name, const char *unit = nullptr) const;
+};
+
+}
+
+#endif
@@ -0,0 +1,521 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+// Standalone link-budget planner: computes the connectivity graph of a deployment for every
+// SF/TP combination with the same mean path loss and sensitivity formulas the simulation uses
+// (src/LoRaPhy/LoRaLinkBudget.h), plus degree, component and hop-count statistics.
+//
+// Usage: lora_linkbudget [--option value]...   (run with --help for the list)
+
+#include "LoRaPhy/LoRaLinkBudget.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace inet::physicallayer::linkbudget;
+
+namespace {
+
+struct Options {
+    std::string deployment = "grid";
+    int nodes = 100;
+    double minX = 0, minY = 0, sepX = 1000, sepY = 1000;
+    int cols = 0;                 // 0: int(sqrt(nodes)), as in LoRaNodeApp
+    double jitter = 100;
+    double rad = 5000, centX = 0, centY = 0;
+    std::string positions;        // CSV with x,y per line (deployment = file)
+    unsigned long seed = 1;
+
+    std::string model = "lognormal";
+    double d0 = -1;               // -1: model default
+    double gamma = 3.5;
+    double n = 2.32, B = 128.95, antennaGain = 2;
+    double K1 = 127.5, K2 = 35.2;
+    double sigma = -1;            // -1: model default
+
+    std::vector<int> sfs = {7, 8, 9, 10, 11, 12};
+    std::vector<double> tps = {14};
+    double bw = 125000;
+    double cadAtt = 0;
+    double marginSigmas = 0;
+
+    int threads = 0;              // 0: hardware concurrency
+    int hopSamples = 0;           // 0: BFS from every node
+    bool writeEdges = false;
+    std::string out = "linkbudget";
+};
+
+struct Combo {
+    int sf;
+    double tp;
+    double maxPathLossDb;
+    double range;
+    double range2;
+};
+
+struct Edge {
+    int i;
+    int j;
+    int firstCombo;   // smallest (range-sorted) combo index that contains this link
+};
+
+void usage()
+{
+    std::cout <<
+        "lora_linkbudget - per-SF/TP connectivity of a LoRa mesh deployment\n"
+        "\n"
+        "Deployment:\n"
+        "  --deployment grid|circle|file   (default grid)\n"
+        "  --nodes N --minX --minY --sepX --sepY --cols --jitter   grid layout as in LoRaNodeApp\n"
+        "  --rad --centX --centY                                   circle layout\n"
+        "  --positions FILE                CSV of x,y per node (deployment file)\n"
+        "  --seed S                        jitter / circle RNG seed\n"
+        "Propagation:\n"
+        "  --model lognormal|oulu|hata     LoRaLogNormalShadowing | LoRaPathLossOulu | LoRaHataOkumura\n"
+        "  --d0 --gamma | --n --B --antennaGain | --K1 --K2   model parameters (NED defaults)\n"
+        "  --sigma DB                      shadowing std dev (NED default of the model)\n"
+        "Radio:\n"
+        "  --sf LIST (7,8,9,10,11,12) --tp LIST dBm (14) --bw HZ (125000) --cadAtt DB (0)\n"
+        "  --marginSigmas K                require mean Rx power >= sensitivity + K*sigma (0)\n"
+        "Output:\n"
+        "  --out PREFIX                    writes PREFIX_summary.csv (default linkbudget)\n"
+        "  --edges                         also write PREFIX_sf<SF>_tp<TP>.csv edge lists\n"
+        "  --threads T --hopSamples K      worker threads; BFS sources (0 = all nodes)\n";
+}
+
+template<typename T>
+std::vector<T> parseList(const std::string& text)
+{
+    std::vector<T> values;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ','))
+        if (!item.empty())
+            values.push_back((T)std::atof(item.c_str()));
+    return values;
+}
+
+bool parseOptions(int argc, char **argv, Options& o)
+{
+    for (int a = 1; a < argc; a++) {
+        std::string key = argv[a];
+        if (key == "--help" || key == "-h") {
+            usage();
+            return false;
+        }
+        if (key == "--edges") {
+            o.writeEdges = true;
+            continue;
+        }
+        if (a + 1 >= argc) {
+            std::cerr << "Missing value for " << key << std::endl;
+            return false;
+        }
+        std::string value = argv[++a];
+        double v = std::atof(value.c_str());
+        if (key == "--deployment") o.deployment = value;
+        else if (key == "--nodes") o.nodes = (int)v;
+        else if (key == "--minX") o.minX = v;
+        else if (key == "--minY") o.minY = v;
+        else if (key == "--sepX") o.sepX = v;
+        else if (key == "--sepY") o.sepY = v;
+        else if (key == "--cols") o.cols = (int)v;
+        else if (key == "--jitter") o.jitter = std::fabs(v);
+        else if (key == "--rad") o.rad = v;
+        else if (key == "--centX") o.centX = v;
+        else if (key == "--centY") o.centY = v;
+        else if (key == "--positions") o.positions = value;
+        else if (key == "--seed") o.seed = std::strtoul(value.c_str(), nullptr, 10);
+        else if (key == "--model") o.model = value;
+        else if (key == "--d0") o.d0 = v;
+        else if (key == "--gamma") o.gamma = v;
+        else if (key == "--n") o.n = v;
+        else if (key == "--B") o.B = v;
+        else if (key == "--antennaGain") o.antennaGain = v;
+        else if (key == "--K1") o.K1 = v;
+        else if (key == "--K2") o.K2 = v;
+        else if (key == "--sigma") o.sigma = v;
+        else if (key == "--sf") o.sfs = parseList<int>(value);
+        else if (key == "--tp") o.tps = parseList<double>(value);
+        else if (key == "--bw") o.bw = v;
+        else if (key == "--cadAtt") o.cadAtt = v;
+        else if (key == "--marginSigmas") o.marginSigmas = v;
+        else if (key == "--threads") o.threads = (int)v;
+        else if (key == "--hopSamples") o.hopSamples = (int)v;
+        else if (key == "--out") o.out = value;
+        else {
+            std::cerr << "Unknown option " << key << " (see --help)" << std::endl;
+            return false;
+        }
+    }
+    // NED defaults of the selected model
+    if (o.model == "lognormal") {
+        if (o.d0 < 0) o.d0 = 190;
+        if (o.sigma < 0) o.sigma = 2.88;
+    }
+    else if (o.model == "oulu") {
+        if (o.d0 < 0) o.d0 = 1000;
+        if (o.sigma < 0) o.sigma = 7.8;
+    }
+    else if (o.model == "hata") {
+        if (o.sigma < 0) o.sigma = 0;
+    }
+    else {
+        std::cerr << "Unknown model " << o.model << std::endl;
+        return false;
+    }
+    if (o.threads <= 0)
+        o.threads = std::max(1u, std::thread::hardware_concurrency());
+    return true;
+}
+
+bool buildPositions(const Options& o, std::vector<double>& xs, std::vector<double>& ys)
+{
+    std::mt19937_64 rng(o.seed);
+    if (o.deployment == "file") {
+        std::ifstream in(o.positions);
+        if (!in.is_open()) {
+            std::cerr << "Cannot open positions file " << o.positions << std::endl;
+            return false;
+        }
+        std::string line;
+        while (std::getline(in, line)) {
+            double x, y;
+            std::replace(line.begin(), line.end(), ',', ' ');
+            std::stringstream ss(line);
+            if (ss >> x >> y) {
+                xs.push_back(x);
+                ys.push_back(y);
+            }
+        }
+    }
+    else if (o.deployment == "grid") {
+        int cols = o.cols > 0 ? o.cols : std::max(1, (int)std::sqrt((double)o.nodes));
+        std::uniform_real_distribution<double> jitter(-o.jitter, o.jitter);
+        for (int id = 0; id < o.nodes; id++) {
+            double jx = o.jitter > 0 ? jitter(rng) : 0;
+            double jy = o.jitter > 0 ? jitter(rng) : 0;
+            xs.push_back(o.minX + o.sepX * (id % cols) + jx);
+            ys.push_back(o.minY + o.sepY * (id / cols) + jy);
+        }
+    }
+    else if (o.deployment == "circle") {
+        // Same uniform-in-disc draw as LoRaNodeApp::generateUniformCircleCoordinates()
+        std::uniform_real_distribution<double> r2(0, o.rad * o.rad);
+        std::uniform_real_distribution<double> theta(0, 2 * M_PI);
+        for (int id = 0; id < o.nodes; id++) {
+            double r = std::sqrt(r2(rng));
+            double t = theta(rng);
+            xs.push_back(o.centX + r * std::cos(t));
+            ys.push_back(o.centY - r * std::sin(t));
+        }
+    }
+    else {
+        std::cerr << "Unknown deployment " << o.deployment << std::endl;
+        return false;
+    }
+    return !xs.empty();
+}
+
+double meanPathLossDb(const Options& o, double distance)
+{
+    distance = std::max(distance, 1.0);
+    if (o.model == "lognormal")
+        return logNormalShadowingPathLossDb(distance, o.d0, o.gamma);
+    else if (o.model == "oulu")
+        return ouluPathLossDb(distance, o.d0, o.n, o.B, o.antennaGain);
+    else
+        return hataOkumuraPathLossDb(distance, o.K1, o.K2);
+}
+
+double rangeForPathLoss(const Options& o, double maxPathLossDb)
+{
+    if (o.model == "lognormal")
+        return logNormalShadowingRange(maxPathLossDb, o.d0, o.gamma);
+    else if (o.model == "oulu")
+        return ouluRange(maxPathLossDb, o.d0, o.n, o.B, o.antennaGain);
+    else
+        return hataOkumuraRange(maxPathLossDb, o.K1, o.K2);
+}
+
+// Runs fn(t, begin, end) on o.threads threads over [0, count) in interleaved blocks so the
+// triangular pair loop stays balanced.
+template<typename Fn>
+void parallelFor(int threads, int count, Fn fn)
+{
+    std::atomic<int> next(0);
+    const int block = 64;
+    auto worker = [&](int t) {
+        for (int begin = next.fetch_add(block); begin < count; begin = next.fetch_add(block))
+            fn(t, begin, std::min(count, begin + block));
+    };
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++)
+        pool.emplace_back(worker, t);
+    worker(0);
+    for (auto& th : pool)
+        th.join();
+}
+
+struct GraphStats {
+    long edges = 0;
+    double avgDegree = 0;
+    int minDegree = 0;
+    int maxDegree = 0;
+    int isolated = 0;
+    int components = 0;
+    int largestComponent = 0;
+    double reachablePairsFraction = 0;
+    double meanHops = 0;
+    int maxHops = 0;
+    std::map<int, long> hopHistogram;
+};
+
+GraphStats analyze(int nodeCount, const std::vector<int>& offsets, const std::vector<int>& neighbors, const Options& o)
+{
+    GraphStats s;
+    s.edges = (long)neighbors.size() / 2;
+    s.minDegree = nodeCount > 0 ? INT32_MAX : 0;
+    for (int i = 0; i < nodeCount; i++) {
+        int degree = offsets[i + 1] - offsets[i];
+        s.minDegree = std::min(s.minDegree, degree);
+        s.maxDegree = std::max(s.maxDegree, degree);
+        if (degree == 0)
+            s.isolated++;
+    }
+    s.avgDegree = nodeCount > 0 ? 2.0 * s.edges / nodeCount : 0;
+
+    // Connected components (serial BFS, linear time)
+    std::vector<int> component(nodeCount, -1);
+    std::vector<int> queue(nodeCount);
+    for (int start = 0; start < nodeCount; start++) {
+        if (component[start] >= 0)
+            continue;
+        int head = 0, tail = 0;
+        queue[tail++] = start;
+        component[start] = s.components;
+        while (head < tail) {
+            int u = queue[head++];
+            for (int k = offsets[u]; k < offsets[u + 1]; k++)
+                if (component[neighbors[k]] < 0) {
+                    component[neighbors[k]] = s.components;
+                    queue[tail++] = neighbors[k];
+                }
+        }
+        s.largestComponent = std::max(s.largestComponent, tail);
+        s.components++;
+    }
+
+    // Hop counts: BFS from every node, or from an evenly spaced sample of sources
+    std::vector<int> sources;
+    if (o.hopSamples <= 0 || o.hopSamples >= nodeCount) {
+        for (int i = 0; i < nodeCount; i++)
+            sources.push_back(i);
+    }
+    else {
+        for (int k = 0; k < o.hopSamples; k++)
+            sources.push_back((int)((long)k * nodeCount / o.hopSamples));
+    }
+    std::vector<std::map<int, long>> histograms(o.threads);
+    parallelFor(o.threads, (int)sources.size(), [&](int t, int begin, int end) {
+        std::vector<int> dist(nodeCount);
+        std::vector<int> q(nodeCount);
+        for (int si = begin; si < end; si++) {
+            std::fill(dist.begin(), dist.end(), -1);
+            int source = sources[si];
+            int head = 0, tail = 0;
+            q[tail++] = source;
+            dist[source] = 0;
+            while (head < tail) {
+                int u = q[head++];
+                for (int k = offsets[u]; k < offsets[u + 1]; k++) {
+                    int v = neighbors[k];
+                    if (dist[v] < 0) {
+                        dist[v] = dist[u] + 1;
+                        q[tail++] = v;
+                        histograms[t][dist[v]]++;
+                    }
+                }
+            }
+        }
+    });
+    long reachable = 0;
+    double hopSum = 0;
+    for (const auto& h : histograms)
+        for (const auto& bucket : h) {
+            s.hopHistogram[bucket.first] += bucket.second;
+            reachable += bucket.second;
+            hopSum += (double)bucket.first * bucket.second;
+            s.maxHops = std::max(s.maxHops, bucket.first);
+        }
+    double possiblePairs = (double)sources.size() * (nodeCount - 1);
+    s.reachablePairsFraction = possiblePairs > 0 ? reachable / possiblePairs : 0;
+    s.meanHops = reachable > 0 ? hopSum / reachable : 0;
+    return s;
+}
+
+double linkProbability(double marginDb, double sigma)
+{
+    if (sigma <= 0)
+        return marginDb >= 0 ? 1 : 0;
+    return 0.5 * std::erfc(-marginDb / (sigma * std::sqrt(2.0)));
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options o;
+    if (!parseOptions(argc, argv, o))
+        return 1;
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<double> xs, ys;
+    if (!buildPositions(o, xs, ys))
+        return 1;
+    const int nodeCount = (int)xs.size();
+
+    // One combo per SF x TP, sorted by range so a pair's membership is a single index
+    std::vector<Combo> combos;
+    for (int sf : o.sfs) {
+        double sensitivity = loRaSensitivityDbm(sf, o.bw);
+        if (std::isnan(sensitivity)) {
+            std::cerr << "No sensitivity for SF" << sf << " / BW " << o.bw << " Hz" << std::endl;
+            return 1;
+        }
+        for (double tp : o.tps) {
+            Combo c;
+            c.sf = sf;
+            c.tp = tp;
+            c.maxPathLossDb = tp - (sensitivity + o.cadAtt) - o.marginSigmas * o.sigma;
+            c.range = rangeForPathLoss(o, c.maxPathLossDb);
+            c.range2 = c.range * c.range;
+            combos.push_back(c);
+        }
+    }
+    if (combos.empty()) {
+        std::cerr << "No SF/TP combination given" << std::endl;
+        return 1;
+    }
+    std::sort(combos.begin(), combos.end(), [](const Combo& a, const Combo& b) { return a.range2 < b.range2; });
+    std::vector<double> ranges2;
+    for (const auto& c : combos)
+        ranges2.push_back(c.range2);
+    const double maxRange2 = ranges2.back();
+
+    // Pair kernel: path loss is monotonic in distance, so a link test is a squared-distance
+    // comparison against the per-combo range; the inner distance loop vectorizes.
+    std::vector<std::vector<Edge>> threadEdges(o.threads);
+    parallelFor(o.threads, nodeCount, [&](int t, int begin, int end) {
+        std::vector<double> d2(nodeCount);
+        auto& edges = threadEdges[t];
+        for (int i = begin; i < end; i++) {
+            const double xi = xs[i], yi = ys[i];
+            const int count = nodeCount - i - 1;
+            const double *xj = xs.data() + i + 1;
+            const double *yj = ys.data() + i + 1;
+            double *out = d2.data();
+            for (int k = 0; k < count; k++) {
+                double dx = xj[k] - xi;
+                double dy = yj[k] - yi;
+                out[k] = dx * dx + dy * dy;
+            }
+            for (int k = 0; k < count; k++) {
+                if (out[k] <= maxRange2) {
+                    int first = (int)(std::lower_bound(ranges2.begin(), ranges2.end(), out[k]) - ranges2.begin());
+                    edges.push_back(Edge{i, i + 1 + k, first});
+                }
+            }
+        }
+    });
+    std::vector<Edge> edges;
+    for (auto& te : threadEdges) {
+        edges.insert(edges.end(), te.begin(), te.end());
+        std::vector<Edge>().swap(te);
+    }
+    std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) { return a.i != b.i ? a.i < b.i : a.j < b.j; });
+
+    std::string summaryPath = o.out + "_summary.csv";
+    std::ofstream summary(summaryPath);
+    if (!summary.is_open()) {
+        std::cerr << "Cannot write " << summaryPath << std::endl;
+        return 1;
+    }
+    summary << "sf,tp_dBm,maxPathLoss_dB,range_m,nodes,edges,avgDegree,minDegree,maxDegree,isolated,components,largestComponent,reachablePairsFraction,meanHops,maxHops\n";
+    std::printf("%d nodes, model %s, sigma %.2f dB, %d threads\n", nodeCount, o.model.c_str(), o.sigma, o.threads);
+    std::printf("%4s %6s %10s %9s %8s %7s %5s %6s %7s %9s %8s\n", "SF", "TP", "range[m]", "edges", "avgDeg", "isol", "comp", "giant", "reach", "meanHops", "maxHops");
+
+    for (int c = 0; c < (int)combos.size(); c++) {
+        const Combo& combo = combos[c];
+        // CSR adjacency of this combo
+        std::vector<int> offsets(nodeCount + 1, 0);
+        for (const auto& e : edges)
+            if (e.firstCombo <= c) {
+                offsets[e.i + 1]++;
+                offsets[e.j + 1]++;
+            }
+        for (int i = 0; i < nodeCount; i++)
+            offsets[i + 1] += offsets[i];
+        std::vector<int> neighbors(offsets[nodeCount]);
+        std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+        for (const auto& e : edges)
+            if (e.firstCombo <= c) {
+                neighbors[fill[e.i]++] = e.j;
+                neighbors[fill[e.j]++] = e.i;
+            }
+
+        GraphStats s = analyze(nodeCount, offsets, neighbors, o);
+        summary << combo.sf << "," << combo.tp << "," << combo.maxPathLossDb << "," << combo.range << ","
+                << nodeCount << "," << s.edges << "," << s.avgDegree << "," << s.minDegree << "," << s.maxDegree << ","
+                << s.isolated << "," << s.components << "," << s.largestComponent << ","
+                << s.reachablePairsFraction << "," << s.meanHops << "," << s.maxHops << "\n";
+        std::printf("%4d %6.1f %10.1f %9ld %8.2f %7d %5d %6d %7.3f %9.2f %8d\n", combo.sf, combo.tp, combo.range, s.edges,
+                s.avgDegree, s.isolated, s.components, s.largestComponent, s.reachablePairsFraction, s.meanHops, s.maxHops);
+
+        if (o.writeEdges) {
+            std::stringstream name;
+            name << o.out << "_sf" << combo.sf << "_tp" << combo.tp << ".csv";
+            std::ofstream edgeFile(name.str());
+            edgeFile << "src,dst,distance_m,meanRxPower_dBm,linkProbability\n";
+            for (const auto& e : edges) {
+                if (e.firstCombo > c)
+                    continue;
+                double distance = std::hypot(xs[e.i] - xs[e.j], ys[e.i] - ys[e.j]);
+                double rxPower = combo.tp - meanPathLossDb(o, distance);
+                double sensitivity = loRaSensitivityDbm(combo.sf, o.bw) + o.cadAtt;
+                edgeFile << e.i << "," << e.j << "," << distance << "," << rxPower << ","
+                         << linkProbability(rxPower - sensitivity, o.sigma) << "\n";
+            }
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::printf("Wrote %s in %.2f s\n", summaryPath.c_str(), seconds);
+    return 0;
+}
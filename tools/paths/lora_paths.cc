@@ -0,0 +1,677 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+// Standalone paths.csv analyzer: rebuilds every packet's hop chain and computes delivery ratio,
+// hop count, latency and per-node forwarding load in one pass, writing the aggregate CSVs of
+// simulations/paths_report.py (pair_report.csv) and endnode_distance_tracker.py /
+// FLOODING_endnode_tracker.py (simulation_summary.csv), plus per-packet and per-node tables.
+//
+// The file is memory-mapped and split into one chunk per thread at line boundaries; threads
+// parse their chunks in parallel, then the rows are folded chunk by chunk, i.e. in file order,
+// which is simulation time order since every node appends to paths.csv as events happen.
+//
+// Usage: lora_paths [--option value]...   (run with --help for the list)
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const int BROADCAST_ADDRESS = 16777215;
+
+struct Options {
+    std::string paths = "delivered_packets/paths.csv";
+    std::string positions;                  // CSV with id,x,y
+    std::string sca;                        // .sca file for end node positions and energy
+    std::string runIndex;
+    std::string pairReport = "pair_report.csv";        // appended, as paths_report.py --output
+    std::string perRunPairReport;                      // overwritten, as paths_report.py --per-run-output
+    std::string summary = "simulation_summary.csv";    // appended, as the end node trackers
+    std::string packets = "packet_paths.csv";
+    std::string nodes = "node_load.csv";
+    int threads = 0;                        // 0: hardware concurrency
+};
+
+enum Event : uint8_t {
+    EV_TX_SRC, EV_TX_FWD, EV_TX_FWD_DATA, EV_TX_FWD_ACK, EV_ENQUEUE_FWD, EV_ENQUEUE_RETX,
+    EV_ENQUEUE_ACK_FWD, EV_TX_ACK, EV_RX_FWD_PRE, EV_RX_DST_PRE, EV_DELIVERED, EV_ACK_DELIVERED,
+    EV_OTHER, EV_COUNT
+};
+
+const char *eventNames[EV_COUNT] = {
+    "TX_SRC", "TX_FWD", "TX_FWD_DATA", "TX_FWD_ACK", "ENQUEUE_FWD", "ENQUEUE_RETX",
+    "ENQUEUE_ACK_FWD", "TX_ACK", "RX_FWD_PRE", "RX_DST_PRE", "DELIVERED", "ACK_DELIVERED",
+    "OTHER"
+};
+
+struct Row {
+    double time;
+    int seq, src, dst, node, ttl, via;
+    Event event;
+};
+
+// Everything known about one packet (src, dst, seq), updated row by row in time order
+struct Packet {
+    int src, dst, seq;
+    bool sourceSeen = false;          // a TX_SRC row set destination and generated time
+    double generated = NAN;           // latest TX_SRC before the current row (tracker semantics)
+    int initialTtl = -1;
+    double firstTx = NAN;             // earliest TX_SRC (paths_report semantics)
+    int firstTxTtl = -1;
+    std::vector<int> pathNodes;       // source, forwarders, delivering nodes, in order of appearance
+    int forwardHops = 0;              // distinct TX_FWD_DATA/ACK nodes
+    std::vector<int> nodesSeen;       // any event
+    bool delivered = false;           // any DELIVERED row
+    std::vector<double> transitTimes; // every copy delivered to the destination
+    std::vector<int> hopCounts;       // initial TTL - TTL at every DELIVERED row
+    double firstTransit = NAN;
+    int firstHops = -1;
+    double firstDeliveryAtDst = NAN;
+    int firstDeliveryAtDstTtl = -1;
+    int copiesAtDst = 0;
+};
+
+struct NodeLoad {
+    long events[EV_COUNT] = {};
+    std::set<int64_t> packetsForwarded;
+};
+
+struct Position {
+    double x = NAN, y = NAN;
+    bool valid() const { return !std::isnan(x) && !std::isnan(y); }
+};
+
+void usage()
+{
+    std::cout <<
+        "Usage: lora_paths [--option value]...\n"
+        "  --paths FILE              paths.csv to analyze (delivered_packets/paths.csv)\n"
+        "  --positions FILE          CSV with id,x,y columns for end node positions\n"
+        "  --sca FILE                .sca file with end node positions (CordiX/CordiY) and energy\n"
+        "  --run-index N             run index recorded in the pair report\n"
+        "  --pair-report FILE        per (src, dst) metrics, appended (pair_report.csv)\n"
+        "  --per-run-pair-report FILE  same rows, overwritten\n"
+        "  --summary FILE            one row per run, appended (simulation_summary.csv)\n"
+        "  --packets FILE            per-packet path and metrics (packet_paths.csv)\n"
+        "  --nodes FILE              per-node event counts and forwarding load (node_load.csv)\n"
+        "  --threads N               parser threads, 0 = all cores (0)\n"
+        "Set a file to \"\" to skip it.\n";
+}
+
+bool parseArgs(int argc, char **argv, Options& options)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            usage();
+            exit(0);
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--paths") options.paths = value;
+        else if (arg == "--positions") options.positions = value;
+        else if (arg == "--sca") options.sca = value;
+        else if (arg == "--run-index") options.runIndex = value;
+        else if (arg == "--pair-report") options.pairReport = value;
+        else if (arg == "--per-run-pair-report") options.perRunPairReport = value;
+        else if (arg == "--summary") options.summary = value;
+        else if (arg == "--packets") options.packets = value;
+        else if (arg == "--nodes") options.nodes = value;
+        else if (arg == "--threads") options.threads = atoi(value.c_str());
+        else {
+            std::cerr << "Unknown option " << arg << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Read-only view of a whole file: mmap where available, otherwise read into memory
+class InputFile
+{
+    const char *data = nullptr;
+    size_t size = 0;
+    std::string buffer;
+#ifndef _WIN32
+    void *mapping = nullptr;
+#endif
+
+  public:
+    bool open(const std::string& path)
+    {
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                madvise(mapping, st.st_size, MADV_SEQUENTIAL);
+                data = static_cast<const char *>(mapping);
+                size = st.st_size;
+                ::close(fd);
+                return true;
+            }
+            mapping = nullptr;
+        }
+        ::close(fd);
+#endif
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            return false;
+        std::ostringstream contents;
+        contents << in.rdbuf();
+        buffer = contents.str();
+        data = buffer.data();
+        size = buffer.size();
+        return true;
+    }
+
+    ~InputFile()
+    {
+#ifndef _WIN32
+        if (mapping != nullptr)
+            munmap(mapping, size);
+#endif
+    }
+
+    const char *begin() const { return data; }
+    const char *end() const { return data + size; }
+};
+
+Event parseEvent(const char *begin, const char *end)
+{
+    size_t length = end - begin;
+    for (int i = 0; i < EV_OTHER; i++)
+        if (strlen(eventNames[i]) == length && memcmp(eventNames[i], begin, length) == 0)
+            return (Event)i;
+    return EV_OTHER;
+}
+
+// Parses the rows in [begin, end), which starts and ends at line boundaries
+void parseChunk(const char *begin, const char *end, std::vector<Row>& rows, long& malformed)
+{
+    const char *p = begin;
+    while (p < end) {
+        const char *lineEnd = static_cast<const char *>(memchr(p, '\n', end - p));
+        if (lineEnd == nullptr)
+            lineEnd = end;
+        const char *fields[9];
+        const char *fieldEnds[9];
+        int count = 0;
+        const char *field = p;
+        for (const char *c = p; c <= lineEnd && count < 9; c++) {
+            if (c == lineEnd || *c == ',') {
+                fields[count] = field;
+                fieldEnds[count] = (c > field && c[-1] == '\r') ? c - 1 : c;
+                count++;
+                field = c + 1;
+            }
+        }
+        if (count >= 8) {
+            Row row;
+            row.time = strtod(fields[0], nullptr);
+            row.event = parseEvent(fields[1], fieldEnds[1]);
+            row.seq = atoi(fields[2]);
+            row.src = atoi(fields[3]);
+            row.dst = atoi(fields[4]);
+            row.node = atoi(fields[5]);
+            row.ttl = atoi(fields[6]);
+            row.via = atoi(fields[7]);
+            rows.push_back(row);
+        }
+        else if (lineEnd > p && !(lineEnd - p == 1 && *p == '\r'))
+            malformed++;
+        p = lineEnd + 1;
+    }
+}
+
+std::vector<std::vector<Row>> parseParallel(const InputFile& file, int threads, long& malformed)
+{
+    const char *begin = file.begin();
+    const char *end = file.end();
+    // Skip the header
+    const char *firstLine = static_cast<const char *>(memchr(begin, '\n', end - begin));
+    begin = firstLine == nullptr ? end : firstLine + 1;
+
+    std::vector<const char *> bounds = {begin};
+    size_t chunk = (end - begin) / threads + 1;
+    for (int i = 1; i < threads; i++) {
+        const char *cut = std::min(end, bounds.back() + chunk);
+        const char *newline = cut < end ? static_cast<const char *>(memchr(cut, '\n', end - cut)) : nullptr;
+        bounds.push_back(newline == nullptr ? end : newline + 1);
+    }
+    bounds.push_back(end);
+
+    std::vector<std::vector<Row>> rows(threads);
+    std::vector<long> bad(threads, 0);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back([&, i]() {
+            rows[i].reserve((bounds[i + 1] - bounds[i]) / 48);
+            parseChunk(bounds[i], bounds[i + 1], rows[i], bad[i]);
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+    for (long b : bad)
+        malformed += b;
+    return rows;
+}
+
+struct PacketKeyHash {
+    size_t operator()(const std::tuple<int, int, int>& key) const
+    {
+        uint64_t h = (uint64_t)(uint32_t)std::get<0>(key) * 0x9E3779B97F4A7C15ULL;
+        h ^= (uint64_t)(uint32_t)std::get<1>(key) * 0xC2B2AE3D27D4EB4FULL;
+        h ^= (uint64_t)(uint32_t)std::get<2>(key) + (h << 6) + (h >> 2);
+        return h;
+    }
+};
+
+void addUnique(std::vector<int>& nodes, int node)
+{
+    if (std::find(nodes.begin(), nodes.end(), node) == nodes.end())
+        nodes.push_back(node);
+}
+
+// Per-row update, following endnode_distance_tracker.py analyze_packet_paths() and
+// paths_report.py compute_report()
+void apply(Packet& packet, const Row& row)
+{
+    addUnique(packet.nodesSeen, row.node);
+    switch (row.event) {
+        case EV_TX_SRC:
+            packet.sourceSeen = true;
+            packet.generated = row.time;
+            packet.initialTtl = row.ttl;
+            if (std::isnan(packet.firstTx)) {
+                packet.firstTx = row.time;
+                packet.firstTxTtl = row.ttl;
+            }
+            packet.pathNodes.push_back(row.node);
+            break;
+        case EV_TX_FWD_DATA:
+        case EV_TX_FWD_ACK:
+            if (std::find(packet.pathNodes.begin(), packet.pathNodes.end(), row.node) == packet.pathNodes.end()) {
+                packet.pathNodes.push_back(row.node);
+                packet.forwardHops++;
+            }
+            break;
+        case EV_DELIVERED: {
+            packet.delivered = true;
+            addUnique(packet.pathNodes, row.node);
+            bool atDestination = row.node == packet.dst;
+            int hops = packet.initialTtl >= 0 ? packet.initialTtl - row.ttl : -1;
+            if (hops >= 0)
+                packet.hopCounts.push_back(hops);
+            if (packet.sourceSeen && atDestination) {
+                packet.transitTimes.push_back(row.time - packet.generated);
+                if (std::isnan(packet.firstTransit)) {
+                    packet.firstTransit = row.time - packet.generated;
+                    packet.firstHops = hops;
+                }
+            }
+            if (row.node == packet.dst) {
+                if (packet.copiesAtDst++ == 0) {
+                    packet.firstDeliveryAtDst = row.time;
+                    packet.firstDeliveryAtDstTtl = row.ttl;
+                }
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// Python's str(round(value, 6)) for the values these reports hold
+std::string pythonRound(double value, int digits)
+{
+    char text[64];
+    snprintf(text, sizeof(text), "%.*f", digits, value);
+    std::string s = text;
+    while (s.size() > 1 && s.back() == '0' && s[s.size() - 2] != '.')
+        s.pop_back();
+    if (s == "-0.0")
+        s = "0.0";
+    return s;
+}
+
+std::string fixed(double value, int digits)
+{
+    if (std::isnan(value))
+        return "";
+    char text[64];
+    snprintf(text, sizeof(text), "%.*f", digits, value);
+    return text;
+}
+
+bool loadPositionsCsv(const std::string& path, std::map<int, Position>& positions)
+{
+    std::ifstream in(path);
+    if (!in)
+        return false;
+    std::string line;
+    std::getline(in, line);
+    std::vector<std::string> header;
+    std::stringstream hs(line);
+    for (std::string column; std::getline(hs, column, ','); )
+        header.push_back(column.substr(0, column.find('\r')));
+    auto column = [&](const char *name) {
+        return (int)(std::find(header.begin(), header.end(), name) - header.begin());
+    };
+    int idColumn = column("id"), xColumn = column("x"), yColumn = column("y");
+    while (std::getline(in, line)) {
+        std::vector<std::string> fields;
+        std::stringstream ls(line);
+        for (std::string field; std::getline(ls, field, ','); )
+            fields.push_back(field);
+        int needed = std::max(idColumn, std::max(xColumn, yColumn));
+        if ((int)fields.size() <= needed)
+            continue;
+        Position& position = positions[atoi(fields[idColumn].c_str())];
+        position.x = atof(fields[xColumn].c_str());
+        position.y = atof(fields[yColumn].c_str());
+    }
+    return true;
+}
+
+// End node positions (loRaEndNodes[i] -> 1000 + i) and total energy, as paths_report.py does
+bool loadScalars(const std::string& path, std::map<int, Position>& positions, double& energy)
+{
+    std::ifstream in(path);
+    if (!in)
+        return false;
+    energy = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.compare(0, 7, "scalar ") != 0)
+            continue;
+        std::stringstream ls(line);
+        std::string keyword, module, name, value;
+        if (!(ls >> keyword >> module >> name >> value))
+            continue;
+        char *valueEnd;
+        double v = strtod(value.c_str(), &valueEnd);
+        if (valueEnd == value.c_str())
+            continue;
+        if (name == "energyConsumedJ" || name == "totalEnergyConsumed") {
+            energy += v;
+            continue;
+        }
+        bool isX = name == "CordiX" || name == "positionX";
+        bool isY = name == "CordiY" || name == "positionY";
+        size_t at = module.find("loRaEndNodes[");
+        if ((!isX && !isY) || at == std::string::npos)
+            continue;
+        int id = 1000 + atoi(module.c_str() + at + strlen("loRaEndNodes["));
+        (isX ? positions[id].x : positions[id].y) = v;
+    }
+    return true;
+}
+
+bool fileHasContent(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    return in && in.tellg() > 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parseArgs(argc, argv, options)) {
+        usage();
+        return 1;
+    }
+    int threads = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+
+    auto startTime = std::chrono::steady_clock::now();
+    InputFile file;
+    if (!file.open(options.paths)) {
+        std::cerr << "Cannot read " << options.paths << "\n";
+        return 1;
+    }
+    long malformed = 0;
+    std::vector<std::vector<Row>> chunks = parseParallel(file, threads, malformed);
+
+    // Fold the rows in file order
+    std::unordered_map<std::tuple<int, int, int>, size_t, PacketKeyHash> packetIndex;
+    std::vector<Packet> packets;
+    std::map<int, NodeLoad> nodeLoad;
+    std::map<std::pair<int, int>, std::vector<size_t>> pairPackets;  // end node pairs only
+    long eventCounts[EV_COUNT] = {};
+    long broadcastRows = 0, unicastRows = 0, rowCount = 0;
+    for (const auto& chunk : chunks) {
+        for (const Row& row : chunk) {
+            rowCount++;
+            eventCounts[row.event]++;
+            (row.via == BROADCAST_ADDRESS ? broadcastRows : unicastRows)++;
+            NodeLoad& load = nodeLoad[row.node];
+            load.events[row.event]++;
+            if (row.event == EV_TX_FWD || row.event == EV_TX_FWD_DATA || row.event == EV_TX_FWD_ACK)
+                load.packetsForwarded.insert(((int64_t)row.src << 40) ^ ((int64_t)row.dst << 20) ^ row.seq);
+
+            auto key = std::make_tuple(row.src, row.dst, row.seq);
+            auto found = packetIndex.find(key);
+            size_t index;
+            if (found == packetIndex.end()) {
+                index = packets.size();
+                packetIndex.emplace(key, index);
+                packets.emplace_back();
+                packets.back().src = row.src;
+                packets.back().dst = row.dst;
+                packets.back().seq = row.seq;
+                if (row.src >= 1000 && row.dst >= 1000)
+                    pairPackets[{row.src, row.dst}].push_back(index);
+            }
+            else
+                index = found->second;
+            apply(packets[index], row);
+        }
+    }
+    chunks.clear();
+
+    std::map<int, Position> positions;
+    double energy = NAN;
+    if (!options.positions.empty() && !loadPositionsCsv(options.positions, positions))
+        std::cerr << "Cannot read " << options.positions << "\n";
+    if (!options.sca.empty()) {
+        double scaEnergy;
+        if (loadScalars(options.sca, positions, scaEnergy))
+            energy = scaEnergy;
+        else
+            std::cerr << "Cannot read " << options.sca << "\n";
+    }
+
+    // pair_report.csv (paths_report.py)
+    std::ostringstream pairRows;
+    int pairCount = 0;
+    for (const auto& pair : pairPackets) {
+        const Packet *first = nullptr;
+        std::set<int> pairNodes;
+        int pairCopies = 0;
+        for (size_t index : pair.second) {
+            const Packet& packet = packets[index];
+            if (!std::isnan(packet.firstTx) && (first == nullptr || packet.firstTx < first->firstTx))
+                first = &packet;
+            pairNodes.insert(packet.nodesSeen.begin(), packet.nodesSeen.end());
+            pairCopies += packet.copiesAtDst;
+        }
+        if (first == nullptr)
+            continue;
+        bool delivered = first->copiesAtDst > 0;
+        int copies = delivered ? first->copiesAtDst : pairCopies;
+        const Position& from = positions[pair.first.first];
+        const Position& to = positions[pair.first.second];
+        pairRows << options.runIndex << ',' << pair.first.first << ',' << pair.first.second << ','
+                 << (from.valid() && to.valid() ? pythonRound(std::hypot(from.x - to.x, from.y - to.y), 2) : "") << ','
+                 << (std::isnan(energy) ? "" : pythonRound(energy, 6)) << ','
+                 << (copies > 0 ? 1 : 0) << ','
+                 << (delivered ? pythonRound(first->firstDeliveryAtDst - first->firstTx, 6) : "") << ','
+                 << (delivered ? std::to_string(first->firstTxTtl - first->firstDeliveryAtDstTtl) : "") << ','
+                 << copies << ','
+                 << pairNodes.size() << ','
+                 << pythonRound(first->firstTx, 6) << ','
+                 << (delivered ? pythonRound(first->firstDeliveryAtDst, 6) : "")
+                 << "\n";
+        pairCount++;
+    }
+    const char *pairHeader = "run_index,src,dst,distance_m,total_energy_j,delivered,transit_time_s,first_packet_hop_count,"
+            "copies_received_at_dst_for_first_packet,unique_nodes_processed_first_packet,first_tx_time_s,first_delivery_time_s\n";
+    if (!options.pairReport.empty()) {
+        bool exists = fileHasContent(options.pairReport);
+        std::ofstream out(options.pairReport, std::ios::app);
+        if (!exists)
+            out << pairHeader;
+        out << pairRows.str();
+    }
+    if (!options.perRunPairReport.empty()) {
+        std::ofstream out(options.perRunPairReport, std::ios::trunc);
+        out << pairHeader << pairRows.str();
+    }
+
+    // simulation_summary.csv (endnode_distance_tracker.py append_to_summary_csv())
+    std::vector<double> transitTimes;
+    std::vector<int> hopCounts;
+    size_t nodesProcessed = 0;
+    for (const Packet& packet : packets) {
+        if (!packet.delivered)
+            continue;
+        transitTimes.insert(transitTimes.end(), packet.transitTimes.begin(), packet.transitTimes.end());
+        if (!packet.hopCounts.empty())
+            hopCounts.insert(hopCounts.end(), packet.hopCounts.begin(), packet.hopCounts.end());
+        else
+            hopCounts.push_back(packet.forwardHops);
+        nodesProcessed = std::max(nodesProcessed, packet.nodesSeen.size());
+    }
+    long generated = eventCounts[EV_TX_SRC];
+    long delivered = eventCounts[EV_DELIVERED];
+    double deliveryRate = generated > 0 ? 100.0 * delivered / generated : 0;
+    double transitSum = 0, transitMin = NAN, transitMax = NAN;
+    for (double t : transitTimes) {
+        transitSum += t;
+        transitMin = std::isnan(transitMin) ? t : std::min(transitMin, t);
+        transitMax = std::isnan(transitMax) ? t : std::max(transitMax, t);
+    }
+    double hopSum = 0;
+    for (int h : hopCounts)
+        hopSum += h;
+    const char *routingMethod = "unknown";
+    if (rowCount > 0) {
+        long forwards = eventCounts[EV_TX_FWD_DATA] + eventCounts[EV_TX_FWD_ACK];
+        if (broadcastRows > 0 && unicastRows == 0)
+            routingMethod = eventCounts[EV_ENQUEUE_FWD] > forwards * 2 ? "flooding" : "broadcast";
+        else if (unicastRows > 0)
+            routingMethod = "routing";
+    }
+    if (!options.summary.empty()) {
+        bool exists = fileHasContent(options.summary);
+        std::ofstream out(options.summary, std::ios::app);
+        if (!exists)
+            out << "timestamp,routing_method,results_dir,report_file,distance_m,endnode_1000_x,endnode_1000_y,"
+                   "endnode_1001_x,endnode_1001_y,packets_generated,packets_delivered,delivery_rate,avg_transit_time,"
+                   "min_transit_time,max_transit_time,avg_hop_count,throughput_packets_per_sec,nodes_processed\n";
+        char timestamp[32];
+        time_t now = time(nullptr);
+        strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
+        size_t slash = options.paths.find_last_of("/\\");
+        std::string resultsDir = slash == std::string::npos ? "." : options.paths.substr(0, slash);
+        const Position& a = positions[1000];
+        const Position& b = positions[1001];
+        out << timestamp << ',' << routingMethod << ',' << resultsDir << ",,"
+            << (a.valid() && b.valid() ? fixed(std::hypot(a.x - b.x, a.y - b.y), 2) : "") << ','
+            << fixed(a.x, 2) << ',' << fixed(a.y, 2) << ',' << fixed(b.x, 2) << ',' << fixed(b.y, 2) << ','
+            << generated << ',' << delivered << ',' << fixed(deliveryRate, 2) << ','
+            << (transitTimes.empty() ? "" : fixed(transitSum / transitTimes.size(), 3)) << ','
+            << fixed(transitMin, 3) << ',' << fixed(transitMax, 3) << ','
+            << (hopCounts.empty() ? "" : fixed(hopSum / hopCounts.size(), 2)) << ','
+            << (transitTimes.empty() || !(transitMax > 0) ? "" : fixed(transitTimes.size() / transitMax, 2)) << ','
+            << nodesProcessed << "\n";
+    }
+
+    // packet_paths.csv: one row per packet with its hop chain
+    if (!options.packets.empty()) {
+        std::ofstream out(options.packets, std::ios::trunc);
+        out << "src,dst,seq,generated_time_s,delivered,copies_at_dst,first_delivery_time_s,first_transit_time_s,"
+               "first_hop_count,forward_hops,unique_nodes,path\n";
+        for (const Packet& packet : packets) {
+            out << packet.src << ',' << packet.dst << ',' << packet.seq << ','
+                << (std::isnan(packet.firstTx) ? "" : pythonRound(packet.firstTx, 6)) << ','
+                << (packet.delivered ? 1 : 0) << ',' << packet.copiesAtDst << ','
+                << (std::isnan(packet.firstDeliveryAtDst) ? "" : pythonRound(packet.firstDeliveryAtDst, 6)) << ','
+                << (std::isnan(packet.firstTransit) ? "" : pythonRound(packet.firstTransit, 6)) << ','
+                << (packet.firstHops < 0 ? "" : std::to_string(packet.firstHops)) << ','
+                << packet.forwardHops << ',' << packet.nodesSeen.size() << ',';
+            for (size_t i = 0; i < packet.pathNodes.size(); i++)
+                out << (i ? ">" : "") << packet.pathNodes[i];
+            out << "\n";
+        }
+    }
+
+    // node_load.csv: events per node and distinct packets it forwarded
+    if (!options.nodes.empty()) {
+        std::ofstream out(options.nodes, std::ios::trunc);
+        out << "node";
+        for (int e = 0; e < EV_COUNT; e++)
+            out << ',' << eventNames[e];
+        out << ",packets_forwarded\n";
+        for (const auto& node : nodeLoad) {
+            out << node.first;
+            for (int e = 0; e < EV_COUNT; e++)
+                out << ',' << node.second.events[e];
+            out << ',' << node.second.packetsForwarded.size() << "\n";
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "Parsed " << rowCount << " rows (" << malformed << " malformed) with " << threads << " threads, "
+              << packets.size() << " packets, " << pairCount << " end node pairs, " << nodeLoad.size() << " nodes in "
+              << fixed(seconds, 3) << " s\n"
+              << "Generated " << generated << ", delivered " << delivered << " (" << fixed(deliveryRate, 2) << "%), routing method "
+              << routingMethod << "\n";
+    return 0;
+}